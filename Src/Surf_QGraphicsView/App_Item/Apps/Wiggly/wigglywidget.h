@@ -43,6 +43,9 @@
 #define WIGGLYWIDGET_H
 
 #include <QBasicTimer>
+#include <QPixmap>
+#include <QRegion>
+#include <QVector>
 #include <QWidget>
 
 /*! \class WigglyWidget
@@ -56,16 +59,38 @@ public:
     WigglyWidget(QWidget *parent = 0);
 
 public slots:
-    void setText(const QString &newText) { text = newText; }
+    void setText(const QString &newText);
 
 protected:
     void paintEvent(QPaintEvent *event);
     void timerEvent(QTimerEvent *event);
+    void changeEvent(QEvent *event);
 
 private:
+    /* One character of the text, pre-rendered into the glyph atlas. */
+    struct Glyph {
+        int originX;  /* Pen position relative to the start of the text. */
+        int left;     /* Left edge of the glyph cell relative to the pen position. */
+        int width;    /* Width of the glyph cell. */
+        int atlasX;   /* Left edge of the glyph cell in the atlas. */
+    };
+
+    void buildGlyphCache();
+    QRect glyphRect(int i, int atStep) const;
+    QRegion textRegion(int atStep) const;
+
     QBasicTimer timer;
     QString text;
     int step;
+
+    QVector<Glyph> glyphs;  /* Per-character layout, rebuilt when text or font changes. */
+    QPixmap glyphAtlas;     /* 16 rows, one per colour step, each holding every glyph. */
+    int glyphTop;           /* Top of a glyph cell relative to the baseline. */
+    int glyphHeight;        /* Height of a glyph cell, i.e. of one atlas row. */
+    int textWidth;
+    int lineHeight;
+    int baselineShift;      /* Font ascent minus descent. */
+    bool glyphCacheValid;
 };
 
 #endif
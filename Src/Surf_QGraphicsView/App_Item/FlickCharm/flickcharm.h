@@ -50,6 +50,7 @@ public:
     ~FlickCharm();
     void activateOn(QWidget *widget, int scrollMode=FLICK_BOTH);
     void deactivateFrom(QWidget *widget);
+    void stop(QWidget *widget);
     bool eventFilter(QObject *object, QEvent *event);
     //void (*toScrollItem)(QWidget *widget, const QPoint &p);
 
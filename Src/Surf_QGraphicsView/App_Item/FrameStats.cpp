@@ -0,0 +1,89 @@
+/*! \file  FrameStats.cpp
+    \brief Implementation of FrameStats class.
+ */
+
+#include <algorithm>
+
+#include "FrameStats.h"
+
+#define NSECS_PER_MSEC 1000000.0
+
+/*! \fn FrameStats::FrameStats()
+    \brief Constructor
+ */
+FrameStats::FrameStats()
+{
+}
+
+/*! \fn void FrameStats::addFrame(qint64 nsecs)
+    \brief Record the painting time of a frame.
+
+    \param[in] nsecs the painting time in nanoseconds, e.g. from QElapsedTimer::nsecsElapsed().
+    \return NONE.
+ */
+void FrameStats::addFrame(qint64 nsecs)
+{
+    m_frameTimes.append(nsecs);
+}
+
+/*! \fn void FrameStats::clear()
+    \brief Forget the recorded frames.
+
+    \param[in] NONE.
+    \return NONE.
+ */
+void FrameStats::clear()
+{
+    m_frameTimes.clear();
+}
+
+/*! \fn int FrameStats::frames() const
+    \brief Return the number of recorded frames.
+
+    \param[in] NONE.
+    \return the frames.
+ */
+int FrameStats::frames() const
+{
+    return m_frameTimes.count();
+}
+
+/*! \fn QString FrameStats::summary() const
+    \brief Summarize the recorded frames, the times in milliseconds with microsecond resolution.
+
+    \param[in] NONE.
+    \return "<frames> frames, average <ms> ms, median <ms> ms, 95th <ms> ms, max <ms> ms".
+ */
+QString FrameStats::summary() const
+{
+    if (m_frameTimes.isEmpty())
+       return QString("0 frames");
+
+    QVector<qint64> sorted = m_frameTimes;
+    std::sort(sorted.begin(), sorted.end());
+
+    qint64 total = 0;
+    for (int i = 0; i < sorted.count(); i++)
+       total += sorted[i];
+
+    return QString("%1 frames, average %2 ms, median %3 ms, 95th %4 ms, max %5 ms")
+           .arg(sorted.count())
+           .arg(total / NSECS_PER_MSEC / sorted.count(), 0, 'f', 3)
+           .arg(percentile(sorted, 50), 0, 'f', 3)
+           .arg(percentile(sorted, 95), 0, 'f', 3)
+           .arg(sorted.last() / NSECS_PER_MSEC, 0, 'f', 3);
+}
+
+/*! \fn qreal FrameStats::percentile(const QVector<qint64> &sorted, int percent) const
+    \brief Return the time under which a given percentage of the frames were painted.
+
+    \param[in] sorted the painting times in ascending order, not empty.
+    \param[in] percent the percentage, 0 to 100.
+    \return the time in milliseconds, by the nearest rank.
+ */
+qreal FrameStats::percentile(const QVector<qint64> &sorted, int percent) const
+{
+    int rank = (sorted.count() * percent + 99) / 100;
+
+    return sorted[qBound(0, rank - 1, sorted.count() - 1)] / NSECS_PER_MSEC;
+}
@@ -0,0 +1,87 @@
+/*! \file  SlideBenchmark.cpp
+    \brief Implementation of SlideBenchmark class.
+ */
+
+#include <QApplication>
+#include <QtGlobal>
+
+#include "SlideBenchmark.h"
+#include "SlidingWindow.h"
+
+/*! \fn SlideBenchmark::SlideBenchmark(const QList<BenchmarkConfig> &configs, int sweeps, const QPoint &pos, QObject *parent)
+    \brief Constructor
+
+    \param[in] configs the configurations, run in this order.
+    \param[in] sweeps the times to slide to the last slide and back, per configuration.
+    \param[in] pos the position of the windows.
+    \param[in] parent the parent object.
+ */
+SlideBenchmark::SlideBenchmark(const QList<BenchmarkConfig> &configs, int sweeps, const QPoint &pos, QObject *parent)
+    : QObject(parent)
+    , m_configs(configs)
+    , m_nSweeps(sweeps)
+    , m_pos(pos)
+    , m_nCurrent(-1)
+    , m_window(NULL)
+{
+}
+
+/*! \fn void SlideBenchmark::start()
+    \brief Open the window of the first configuration and start sliding.
+
+    \param[in] NONE.
+    \return NONE.
+ */
+void SlideBenchmark::start()
+{
+    m_nCurrent = -1;
+    runNext();
+}
+
+/*! \fn void SlideBenchmark::runNext()
+    \brief Open the window of the next configuration, or quit after the last one.
+
+    \param[in] NONE.
+    \return NONE.
+ */
+void SlideBenchmark::runNext()
+{
+    if (++m_nCurrent >= m_configs.count())
+    {
+       qApp->quit();
+       return;
+    }
+
+    const BenchmarkConfig &config = m_configs.at(m_nCurrent);
+
+    m_window = new SlidingWindow(config.options);
+    if (config.profile >= 0)
+       m_window->setRenderProfile(static_cast<RenderProfile>(config.profile));
+
+    QObject::connect(m_window, SIGNAL(benchmarkFinished(QString)), this, SLOT(windowFinished(QString)));
+
+    m_window->move(m_pos);
+    m_window->show();
+    m_window->startBenchmark(m_nSweeps);
+}
+
+/*! \fn void SlideBenchmark::windowFinished(const QString &summary)
+    \brief Print the painting times of the running configuration, close its window and run the next one.
+
+    \param[in] summary the painting times reported by the window.
+    \return NONE.
+ */
+void SlideBenchmark::windowFinished(const QString &summary)
+{
+    const BenchmarkConfig &config = m_configs.at(m_nCurrent);
+
+    qDebug("Benchmark%s%s, render profile %s : %s", config.name.isEmpty() ? "" : " ", qPrintable(config.name),
+           qPrintable(SlidingWindow::renderProfileName(m_window->renderProfile())), qPrintable(summary));
+
+    /* Called from the window, it is deleted once back in the event loop. */
+    m_window->hide();
+    m_window->deleteLater();
+    m_window = NULL;
+
+    runNext();
+}
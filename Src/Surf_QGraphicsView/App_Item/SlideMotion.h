@@ -0,0 +1,41 @@
+/*! \file  SlideMotion.h
+    \brief Declaration of SlideMotion class.
+ */
+
+#ifndef SLIDEMOTION_H
+#define SLIDEMOTION_H
+
+#include <QtGlobal>
+
+/*! \class SlideMotion
+    \brief The path of a slide animation which can be retargeted while it runs.
+
+    The position follows a cubic Hermite curve from a start position and
+    velocity to the target, where it comes to rest. Retargeting starts a new
+    curve from the position and velocity at the current progress, so the
+    motion never jumps nor changes speed abruptly. The progress runs from 0
+    to 1 over the animation duration and the velocity is in units per
+    duration, e.g. a timeline with a linear curve drives it.
+*/
+class SlideMotion
+{
+public:
+    SlideMotion();  /*!< Constructor */
+
+    void start(qreal from, qreal to, qreal velocity);  /*!< Begin a motion at rest or at a given speed. */
+    void retarget(qreal to);  /*!< Head for a new target from where the motion is now. */
+    void setProgress(qreal progress);
+    qreal progress() const;
+
+    qreal position() const;
+    qreal velocity() const;
+    qreal target() const;
+
+private:
+    qreal m_from;      /*!< The position at progress 0. */
+    qreal m_to;        /*!< The target, reached at progress 1. */
+    qreal m_velocity;  /*!< The velocity at progress 0, in units per duration. */
+    qreal m_progress;
+};
+
+#endif /* SLIDEMOTION_H */
@@ -10,76 +10,209 @@
  */
 
 #include <QDebug>
+#include <QSettings>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QDesktopWidget>
+
+#ifdef Q_WS_X11
+#include <QX11Info>
+#elif defined(HAVE_X11EXTRAS)
+#include <QtX11Extras/QX11Info>
+#if QT_VERSION < 0x050700
+#include <stdlib.h>
+#include <xcb/xcb.h>
+#endif
+#endif
 
 #include "SlidingWindow.h"
 
-/* The dimension of the main window. */
+/* The default dimension of the main window. */
 #define MAIN_WIN_WIDTH  1024
 #define MAIN_WIN_HEIGHT  600
 
-/* The dimension of item in the sliding window. */
+/* The default dimension of item in the sliding window. The item height is the window height. */
 #define ITEM_WIDTH   350
-#define ITEM_HEIGHT  MAIN_WIN_HEIGHT
 #define ITEM_GAP     200
 
-#define SLIDE_OFFSET (ITEM_WIDTH+50)   /* The moving offset. */
+#define SLIDE_OFFSET (ITEM_WIDTH+50)   /* The default moving offset. */
+
+/* The optional configuration file overriding the default geometry, e.g.
+     [Window]
+     Width=800
+     Height=480
+     FitScreen=false
+     [Layout]
+     ItemWidth=300
+     ItemGap=150
+     SlideOffset=350
+     AnimationDuration=2000
+     [Render]
+     Profile=lowpower
+     ReportFrameTime=true
+ */
+#define DFLT_CONFIG_FILE "SlidingWindow.ini"
+
+#define DFLT_RENDER_PROFILE "default"  /* "default", "lowpower" or "quality", see RenderProfile. */
+#define FRAME_TIME_REPORT_FRAMES 100   /* Print the painting time every that many frames. */
+#define BENCHMARK_SETTLE_TIME 1000     /* The wait in milliseconds before a benchmark, for the first frames. */
 
-#ifdef USE_CONTROL_PANEL
 /* The initial position of control panel. */
 #define CTRL_PANEL_POS_X 570
 #define CTRL_PANEL_POS_Y 640
 
 #define ITEM_POS_START_X 0  /* The x-axis value for the first item. */
-#define ANIMATION_DURATION 2000
-#endif
+
+#define ANIMATION_DURATION 2000  /* The default animation duration in milliseconds. */
 
 #define DEBUG // To show debugging messages.
 
-/*! \fn SlidingWindow::SlidingWindow()
-    \brief Constructor.
+/*! \fn static bool isCompositingManagerRunning()
+    \brief Check if a compositing manager blends translucent windows with what is behind them.
 
     \param[in] NONE.
+    \return true if translucent windows are composited.
+ */
+static bool isCompositingManagerRunning()
+{
+#if defined(Q_WS_X11)
+    return QX11Info::isCompositingManagerRunning();
+#elif defined(HAVE_X11EXTRAS) && QT_VERSION >= 0x050200
+    /* E.g. Wayland, which composites every window. */
+    if (!QX11Info::isPlatformX11())
+       return true;
+
+    #if QT_VERSION >= 0x050700
+    return QX11Info::isCompositingManagerRunning();
+    #else
+    /* A compositing manager owns the _NET_WM_CM_S<screen> selection, as QX11Info checks since Qt 5.7. */
+    xcb_connection_t *connection = QX11Info::connection();
+    QByteArray name = "_NET_WM_CM_S" + QByteArray::number(QX11Info::appScreen());
+
+    xcb_intern_atom_reply_t *atom = xcb_intern_atom_reply(connection, xcb_intern_atom(connection, 0, name.length(), name.constData()), NULL);
+    if (atom == NULL)
+       return false;
+
+    xcb_get_selection_owner_reply_t *owner = xcb_get_selection_owner_reply(connection, xcb_get_selection_owner(connection, atom->atom), NULL);
+    bool running = (owner != NULL && owner->owner != XCB_NONE);
+
+    free(owner);
+    free(atom);
+    return running;
+    #endif
+#else
+    /* Other window systems, or Qt5 built without QtX11Extras, cannot be asked here; assume they composite. */
+    return true;
+#endif
+}
+
+/*! \fn static void applyRenderProfile(QGraphicsView *view, RenderProfile profile)
+    \brief Set the viewport update mode, optimization flags, cache mode and render hints of a view.
+
+    \param[in] view the view to tune.
+    \param[in] profile the rendering profile.
+    \return NONE.
+ */
+static void applyRenderProfile(QGraphicsView *view, RenderProfile profile)
+{
+    switch (profile)
+    {
+    case RENDER_LOW_POWER:
+       /* One repaint rectangle around all changes, no painter state saved or
+          adjusted per item (items restore what they change), no antialiasing. */
+       view->setViewportUpdateMode(QGraphicsView::BoundingRectViewportUpdate);
+       view->setOptimizationFlags(QGraphicsView::DontSavePainterState | QGraphicsView::DontAdjustForAntialiasing);
+       view->setCacheMode(QGraphicsView::CacheBackground);
+       view->setRenderHints(QPainter::RenderHints());
+       break;
+
+    case RENDER_QUALITY:
+       view->setViewportUpdateMode(QGraphicsView::MinimalViewportUpdate);
+       view->setOptimizationFlags(QGraphicsView::OptimizationFlags());
+       view->setCacheMode(QGraphicsView::CacheNone);
+       view->setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform | QPainter::TextAntialiasing);
+       break;
+
+    default:
+       /* Qt's defaults. */
+       view->setViewportUpdateMode(QGraphicsView::MinimalViewportUpdate);
+       view->setOptimizationFlags(QGraphicsView::OptimizationFlags());
+       view->setCacheMode(QGraphicsView::CacheNone);
+       view->setRenderHints(QPainter::TextAntialiasing);
+       break;
+    }
+}
+
+/*! \fn SlidingWindow::SlidingWindow(int options)
+    \brief Constructor.
+
+    \param[in] options the switched on features, OR-ed SlidingWindowOption values.
     \return NONE.
  */
-SlidingWindow::SlidingWindow()
+SlidingWindow::SlidingWindow(int options)
     : QGraphicsView()
-    #ifdef USE_CONTROL_PANEL
+    , m_nOptions(options)
     , m_nNewPosOfFirstItem(0)
-    #endif
-    #ifndef USE_CONTROL_PANEL
     , m_flickcharm(this)
-    #endif
     , m_flipClock(NULL)
     , m_digitClock(NULL)
     , m_analogClock(NULL)
     , m_wigglyText(NULL)
     , m_parallaxHome(NULL)
+    , m_nItemWidth(ITEM_WIDTH)
+    , m_nItemGap(ITEM_GAP)
+    , m_nSlideOffset(SLIDE_OFFSET)
+    , m_nAnimationDuration(ANIMATION_DURATION)
+    , m_renderProfile(RENDER_DEFAULT)
+    , m_bReportFrameTime(false)
+    , m_nBenchSweeps(0)
+    , m_nBenchStep(-1)
 {
     /* Set the view widget to be frameless. */
     setWindowFlags(Qt::FramelessWindowHint);
 
-#ifdef ENABLE_TRANSPARENT_FRAME
-    /* To set the scene's background to be transparent */
-    /* LOOK! These two lines will take effect only when COMPIZ(compositing manager) is OPENED */
-    /* When using this line, it must set WindowFlags "Qt::FramelessWindowHint" */
-    setAttribute(Qt::WA_TranslucentBackground);
-
-    /* There are three ways to achieve transparent window frame effect. */
-    #if 1
-    /* <Way - 1> */
-    viewport()->setAutoFillBackground(false);
-    #elif 0
-    /* <Way - 2> */
-    QPalette p = viewport()->palette();
-
-    p.setColor(QPalette::Base, Qt::transparent);
-    viewport()->setPalette(p);
-    #elif 0
-    /* <Way - 3>
-       Someone may suggest this way. */
-    setStyleSheet("background: transparent");
-    #endif
-#endif
+    /* A translucent window is rendered into an ARGB32 backing store and blended
+       every frame, which is wasted without a compositing manager to show it. */
+    if (testOption(SW_TRANSPARENT_FRAME) && !isCompositingManagerRunning())
+    {
+       #ifdef DEBUG
+       qDebug("%s : %s(%d) - No compositing manager, use an opaque window.", __FILE__, __FUNCTION__, __LINE__);
+       #endif
+
+       m_nOptions &= ~SW_TRANSPARENT_FRAME;
+    }
+
+    if (testOption(SW_TRANSPARENT_FRAME))
+    {
+       /* To set the scene's background to be transparent */
+       /* LOOK! These two lines will take effect only when COMPIZ(compositing manager) is OPENED */
+       /* When using this line, it must set WindowFlags "Qt::FramelessWindowHint" */
+       setAttribute(Qt::WA_TranslucentBackground);
+
+       /* There are three ways to achieve transparent window frame effect. */
+       #if 1
+       /* <Way - 1> */
+       viewport()->setAutoFillBackground(false);
+       #elif 0
+       /* <Way - 2> */
+       QPalette p = viewport()->palette();
+
+       p.setColor(QPalette::Base, Qt::transparent);
+       viewport()->setPalette(p);
+       #elif 0
+       /* <Way - 3>
+          Someone may suggest this way. */
+       setStyleSheet("background: transparent");
+       #endif
+    }
+    else
+    {
+       /* The view fills the background itself with one opaque brush, so the
+          viewport needs neither clearing nor blending before each paint. */
+       viewport()->setAttribute(Qt::WA_OpaquePaintEvent);
+       viewport()->setAttribute(Qt::WA_NoSystemBackground);
+       setBackgroundBrush(viewport()->palette().brush(QPalette::Base));
+    }
 
     /* To set the scene(canvas) */
     setScene(&scene);
@@ -89,53 +222,281 @@ SlidingWindow::SlidingWindow()
     setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
 
     /* Add QGraphicsView object into FlickCharm. */
-    #ifndef USE_CONTROL_PANEL
-    m_flickcharm.activateOn(this, FLICK_HORIZONTAL);
-    #endif
+    if (!testOption(SW_CONTROL_PANEL))
+       m_flickcharm.activateOn(this, FLICK_HORIZONTAL);
 
-    #if 0 // These two lines are for real device.
-    /* Set the window size fitting the dimension of the screen. */
-    QRect screen_size = QApplication::desktop()->screenGeometry();
-    setFixedSize(screen_size.width(), screen_size.height());
-    #else  // This is for simulating on development environment.
-    /* Set the window size. */
-    setFixedSize((int)MAIN_WIN_WIDTH, (int)MAIN_WIN_HEIGHT);
-    #endif
+    /* Set the window size from the configuration file or the screen. */
+    setFixedSize(loadLayout());
 
     /* To set the UI Designer created form instance to a QWidget instance. */
-    #ifdef USE_CONTROL_PANEL
-    QWidget *toolWidget = new QWidget(this);
+    if (testOption(SW_CONTROL_PANEL))
+    {
+       QWidget *toolWidget = new QWidget(this);
 
-    toolWidget->setWindowFlags(Qt::Tool);
-    m_slideControl.setupUi(toolWidget);
-    toolWidget->move(QPoint(CTRL_PANEL_POS_X, CTRL_PANEL_POS_Y));
-    toolWidget->show();
+       toolWidget->setWindowFlags(Qt::Tool);
+       m_slideControl.setupUi(toolWidget);
+       toolWidget->move(QPoint(CTRL_PANEL_POS_X, CTRL_PANEL_POS_Y));
+       toolWidget->show();
 
-    /* Connect the buttons' event handler. */
-    QObject::connect(m_slideControl.pushButtonLeft, SIGNAL(clicked()), this, SLOT(slideLeft()));
-    QObject::connect(m_slideControl.pushButtonRight, SIGNAL(clicked()), this, SLOT(slideRight()));
-    QObject::connect(m_slideControl.pushButtonClose, SIGNAL(clicked()), QApplication::instance(), SLOT(quit()));
+       /* Connect the buttons' event handler. */
+       QObject::connect(m_slideControl.pushButtonLeft, SIGNAL(clicked()), this, SLOT(slideLeft()));
+       QObject::connect(m_slideControl.pushButtonRight, SIGNAL(clicked()), this, SLOT(slideRight()));
+       QObject::connect(m_slideControl.pushButtonClose, SIGNAL(clicked()), QApplication::instance(), SLOT(quit()));
+    }
 
-    /* Set timeline easing curve. */
-    m_timelineItem.setCurveShape(QTimeLine::EaseInOutCurve);
+    /* The timeline only measures the progress, m_motion eases in and out, see slideBy().
+       It also animates goToSlide() when flicking. */
+    m_timelineItem.setCurveShape(QTimeLine::LinearCurve);
 
     /* Set timeline's "new-frame" event handler */
-    QObject::connect(&m_timelineItem, SIGNAL(frameChanged(int)), this, SLOT(moveItem(int)));
+    QObject::connect(&m_timelineItem, SIGNAL(valueChanged(qreal)), this, SLOT(stepSlide(qreal)));
 
     /* Set timeline's "finished" event handler */
     QObject::connect(&m_timelineItem, SIGNAL(finished()), this, SLOT(moveItemFinish()));
 
     /* Set the duration of animation. */
-    m_timelineItem.setDuration((int)ANIMATION_DURATION);
+    m_timelineItem.setDuration(m_nAnimationDuration);
     m_timelineItem.stop();
-    #endif
 
     addDefaultWidgetItems();
+    setRenderProfile(m_renderProfile);
 
     /* Move the first image. */
-    #ifdef USE_CONTROL_PANEL
-    slideBy(0);
-    #endif
+    if (testOption(SW_CONTROL_PANEL))
+       slideBy(0);
+}
+
+/*! \fn bool SlidingWindow::testOption(SlidingWindowOption option) const
+    \brief Check if a feature of the sliding window is switched on.
+
+    \param[in] option the feature to check.
+    \return true if the feature is switched on.
+ */
+bool SlidingWindow::testOption(SlidingWindowOption option) const
+{
+    return (m_nOptions & option) != 0;
+}
+
+/*! \fn void SlidingWindow::setRenderProfile(RenderProfile profile)
+    \brief Tune the views, ParallaxHome included, for power or quality, see RenderProfile.
+
+    \param[in] profile the rendering profile.
+    \return NONE.
+ */
+void SlidingWindow::setRenderProfile(RenderProfile profile)
+{
+    m_renderProfile = profile;
+
+    applyRenderProfile(this, profile);
+    if (m_parallaxHome != NULL)
+       applyRenderProfile(m_parallaxHome, profile);
+
+    m_frameStats.clear();
+}
+
+/*! \fn RenderProfile SlidingWindow::renderProfile() const
+    \brief Return the rendering profile of the view.
+
+    \param[in] NONE.
+    \return the rendering profile.
+ */
+RenderProfile SlidingWindow::renderProfile() const
+{
+    return m_renderProfile;
+}
+
+/*! \fn QString SlidingWindow::renderProfileName(RenderProfile profile)
+    \brief Return the name of a rendering profile, as "Render/Profile" of the layout file gives it.
+
+    \param[in] profile the rendering profile.
+    \return "default", "lowpower" or "quality".
+ */
+QString SlidingWindow::renderProfileName(RenderProfile profile)
+{
+    switch (profile)
+    {
+    case RENDER_LOW_POWER:
+       return "lowpower";
+    case RENDER_QUALITY:
+       return "quality";
+    default:
+       return "default";
+    }
+}
+
+/*! \fn RenderProfile SlidingWindow::renderProfileFromName(const QString &name, bool *ok)
+    \brief Return the rendering profile of a name, see renderProfileName().
+
+    \param[in] name the name of the profile.
+    \param[out] ok false if the name is unknown, the default profile is returned then.
+    \return the rendering profile.
+ */
+RenderProfile SlidingWindow::renderProfileFromName(const QString &name, bool *ok)
+{
+    RenderProfile profile = RENDER_DEFAULT;
+
+    if (name == "lowpower")
+       profile = RENDER_LOW_POWER;
+    else if (name == "quality")
+       profile = RENDER_QUALITY;
+
+    if (ok != NULL)
+       *ok = (profile != RENDER_DEFAULT || name == "default");
+
+    return profile;
+}
+
+/*! \fn void SlidingWindow::paintEvent(QPaintEvent *event)
+    \brief Paint the view, measuring the painting time when "ReportFrameTime" is set or a benchmark runs.
+
+    \param[in] QPaintEvent object.
+    \return NONE.
+ */
+void SlidingWindow::paintEvent(QPaintEvent *event)
+{
+    bool benchmarking = (m_nBenchStep > 0);
+    if (!m_bReportFrameTime && !benchmarking)
+    {
+       QGraphicsView::paintEvent(event);
+       return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QGraphicsView::paintEvent(event);
+
+    qint64 elapsed = timer.nsecsElapsed();
+    if (benchmarking)
+       m_benchStats.addFrame(elapsed);
+
+    if (!m_bReportFrameTime)
+       return;
+
+    m_frameStats.addFrame(elapsed);
+    if (m_frameStats.frames() == FRAME_TIME_REPORT_FRAMES)
+    {
+       qDebug("Render profile %s : %s", qPrintable(renderProfileName(m_renderProfile)), qPrintable(m_frameStats.summary()));
+       m_frameStats.clear();
+    }
+}
+
+/*! \fn void SlidingWindow::startBenchmark(int sweeps)
+    \brief Slide from the first slide to the last one and back, measuring each frame, then emit benchmarkFinished().
+
+    The slides are slid one by one with the configured animation, the same
+    path on every run, so runs of two builds or two rendering profiles on
+    a device can be compared. The painting times are measured with
+    QElapsedTimer, in nanoseconds.
+
+    \param[in] sweeps the times to slide to the last slide and back.
+    \return NONE.
+ */
+void SlidingWindow::startBenchmark(int sweeps)
+{
+    m_nBenchSweeps = qMax(1, sweeps);
+    m_nBenchStep = 0;
+    m_benchStats.clear();
+
+    goToSlide(0, false);
+
+    /* The frames of the window showing up are not part of the sweep. */
+    QTimer::singleShot(BENCHMARK_SETTLE_TIME, this, SLOT(benchmarkStep()));
+}
+
+/*! \fn void SlidingWindow::benchmarkStep()
+    \brief Slide to the next slide of the benchmark, or report it when all sweeps are done.
+
+    \param[in] NONE.
+    \return NONE.
+ */
+void SlidingWindow::benchmarkStep()
+{
+    if (m_nBenchStep < 0)
+       return;
+
+    int last = sceneProxyWidgets.count() - 1;
+    int steps = 2 * qMax(0, last) * m_nBenchSweeps;
+
+    if (m_nBenchStep == 0)
+       m_benchClock.start();
+
+    if (m_nBenchStep >= steps)
+    {
+       qint64 elapsed = m_benchClock.nsecsElapsed();
+       m_nBenchStep = -1;
+
+       emit benchmarkFinished(QString("%1 sweeps of %2 slides in %3 ms, %4").arg(m_nBenchSweeps).arg(last + 1)
+                              .arg(elapsed / 1000000.0, 0, 'f', 3).arg(m_benchStats.summary()));
+       return;
+    }
+
+    /* Forward to the last slide, then back to the first one. */
+    int turn = m_nBenchStep % (2 * last);
+    int index = (turn < last) ? turn + 1 : 2 * last - turn - 1;
+
+    m_nBenchStep++;
+    goToSlide(index, true);
+}
+
+/*! \fn QSize SlidingWindow::loadLayout()
+    \brief Load the window geometry and slide layout of this device.
+
+    The values come from the configuration file when it has them, the window
+    size from the screen when "FitScreen" is set, and the built-in defaults otherwise.
+
+    \param[in] NONE.
+    \return the window size.
+ */
+QSize SlidingWindow::loadLayout()
+{
+   QSettings settings(DFLT_CONFIG_FILE, QSettings::IniFormat);
+   QSize winSize(settings.value("Window/Width", (int)MAIN_WIN_WIDTH).toInt(),
+                 settings.value("Window/Height", (int)MAIN_WIN_HEIGHT).toInt());
+
+   /* Set the window size fitting the dimension of the screen, e.g. for real device. */
+   if (settings.value("Window/FitScreen", false).toBool())
+      winSize = QApplication::desktop()->screenGeometry().size();
+
+   if (winSize.isEmpty())
+      winSize = QSize((int)MAIN_WIN_WIDTH, (int)MAIN_WIN_HEIGHT);
+
+   m_nItemWidth = settings.value("Layout/ItemWidth", (int)ITEM_WIDTH).toInt();
+   m_nItemGap = settings.value("Layout/ItemGap", (int)ITEM_GAP).toInt();
+   m_nSlideOffset = settings.value("Layout/SlideOffset", (int)SLIDE_OFFSET).toInt();
+   m_nAnimationDuration = settings.value("Layout/AnimationDuration", (int)ANIMATION_DURATION).toInt();
+
+   /* The rendering profile, and whether to measure it. */
+   m_renderProfile = renderProfileFromName(settings.value("Render/Profile", DFLT_RENDER_PROFILE).toString());
+
+   m_bReportFrameTime = settings.value("Render/ReportFrameTime", false).toBool();
+
+   #ifdef DEBUG
+   qDebug("%s : %s(%d) - window = %dx%d, item = %d, gap = %d, offset = %d, animation = %d ms",
+          __FILE__, __FUNCTION__, __LINE__, winSize.width(), winSize.height(),
+          m_nItemWidth, m_nItemGap, m_nSlideOffset, m_nAnimationDuration);
+   #endif
+
+   return winSize;
+}
+
+/*! \fn void SlidingWindow::resizeEvent(QResizeEvent *event)
+    \brief Fit the widget items to the new window height and place them again.
+
+    \param[in] QResizeEvent object.
+    \return NONE.
+ */
+void SlidingWindow::resizeEvent(QResizeEvent *event)
+{
+   QGraphicsView::resizeEvent(event);
+
+   if (event->size().height() == event->oldSize().height())
+      return;
+
+   for (int i = 0; i < slideItems.count(); i++)
+      slideItems[i]->resize(m_nItemWidth, event->size().height());
+
+   scene.setSceneRect(scene.itemsBoundingRect());
 }
 
 /*! \fn void SlidingWindow::addDefaultWidgetItems()
@@ -148,34 +509,30 @@ void SlidingWindow::addDefaultWidgetItems()
 {
    /* Flipping digital clock */
    m_flipClock = new DigiFlip();
-   m_flipClock->resize(ITEM_WIDTH, ITEM_HEIGHT);
+   m_flipClock->resize(m_nItemWidth, height());
    addWidgetItem(m_flipClock);
 
    /* Digital number clock */
    m_digitClock = new DigitalClock();
    m_digitClock->setWindowFlags(Qt::FramelessWindowHint);  /* Set the view widget to be frameless. */
-   m_digitClock->resize(ITEM_WIDTH, ITEM_HEIGHT);
+   m_digitClock->resize(m_nItemWidth, height());
    addWidgetItem(m_digitClock);
 
    /* Analog clock */
    m_analogClock = new AnalogClock();
-   #ifdef ENABLE_TRANSPARENT_FRAME
-   m_analogClock->setStyleSheet("background: transparent");
-   #endif
-   m_analogClock->resize(ITEM_WIDTH, ITEM_HEIGHT);
+   if (testOption(SW_TRANSPARENT_FRAME))
+      m_analogClock->setStyleSheet("background: transparent");
+   m_analogClock->resize(m_nItemWidth, height());
    addWidgetItem(m_analogClock);
 
    /* Wiggly text */
    m_wigglyText = new WigglyText(0, true);  /* true for using small screen. */
-   #ifdef ENABLE_TRANSPARENT_FRAME
-   m_analogClock->setStyleSheet("background: transparent");
-   #endif
-   m_wigglyText->resize(ITEM_WIDTH, ITEM_HEIGHT);
+   m_wigglyText->resize(m_nItemWidth, height());
    addWidgetItem(m_wigglyText);
 
    /* Parallax Home */
    m_parallaxHome = new ParallaxHome();  /* true for using small screen. */
-   m_parallaxHome->resize(ITEM_WIDTH, ITEM_HEIGHT);
+   m_parallaxHome->resize(m_nItemWidth, height());
    addWidgetItem(m_parallaxHome);
 }
 
@@ -190,17 +547,16 @@ void SlidingWindow::addWidgetItem(QWidget* widget)
    if (widget == NULL)
      return;
 
-   #ifndef USE_CONTROL_PANEL
-   widget->installEventFilter(&m_flickcharm);
-   #endif
+   if (!testOption(SW_CONTROL_PANEL))
+      widget->installEventFilter(&m_flickcharm);
 
    /* Add the new created widget to the scene */
    QGraphicsProxyWidget *proxyWidget = scene.addWidget(widget);
 
    if (slideItems.count() == 0)
-       proxyWidget->setPos((slideItems.count() * ITEM_WIDTH), 0);
+       proxyWidget->setPos((slideItems.count() * m_nItemWidth), 0);
    else
-       proxyWidget->setPos((slideItems.count() * (ITEM_WIDTH + ITEM_GAP)), 0);
+       proxyWidget->setPos((slideItems.count() * (m_nItemWidth + m_nItemGap)), 0);
 
    sceneProxyWidgets += proxyWidget; /* Add the new created proxy widget to the proxy widget list. */
 
@@ -214,7 +570,6 @@ void SlidingWindow::addWidgetItem(QWidget* widget)
    #endif
 }
 
-#ifdef USE_CONTROL_PANEL
 /*! \fn void SlidingWindow::slideLeft()
     \brief The slot to handle sliding items LEFT process.
 
@@ -227,15 +582,8 @@ void SlidingWindow::slideLeft()
    qDebug(" Push Left button! nOffset = %d", m_nNewPosOfFirstItem);
    #endif
 
-   /* Determine if the timeline is running now. If it is running, just return. */
-   if(m_timelineItem.state() != QTimeLine::NotRunning)
-   {
-      qDebug(" Timeline is still Running! ");
-      return;
-   }
-
    if( !(m_nNewPosOfFirstItem >= ITEM_POS_START_X) )
-     slideBy(SLIDE_OFFSET);
+     slideBy(m_nSlideOffset);
 }
 
 /*! \fn void SlidingWindow::slideRight()
@@ -250,15 +598,8 @@ void SlidingWindow::slideRight()
    qDebug(" Push Right button! nOffset = %d", m_nNewPosOfFirstItem);
    #endif
 
-   /* Determine if the timeline is running now. If it is running, just return. */
-   if(m_timelineItem.state() != QTimeLine::NotRunning)
-   {
-      qDebug(" Timeline is still Running! ");
-      return;
-   }
-
-   if( !(m_nNewPosOfFirstItem <= -(SLIDE_OFFSET * (sceneProxyWidgets.count()-1))) )
-      slideBy(-SLIDE_OFFSET);
+   if( !(m_nNewPosOfFirstItem <= -(m_nSlideOffset * (sceneProxyWidgets.count()-1))) )
+      slideBy(-m_nSlideOffset);
 }
 
 /*! \fn void SlidingWindow::moveItem(int offset)
@@ -276,10 +617,26 @@ void SlidingWindow::moveItem(int offset)
    if (sceneProxyWidgets.count() > 1)
    {
      for(int i = 0; i < sceneProxyWidgets.count(); i++)
-       sceneProxyWidgets[i]->setPos((offset + i * (ITEM_WIDTH + ITEM_GAP)), sceneProxyWidgets[i]->pos().y());
+       sceneProxyWidgets[i]->setPos((offset + i * (m_nItemWidth + m_nItemGap)), sceneProxyWidgets[i]->pos().y());
    }
 }
 
+/*! \fn void SlidingWindow::stepSlide(qreal progress)
+    \brief The slot moving the items along the running slide animation.
+
+    \param[in] progress the progress of the timeline, 0 to 1.
+    \return NONE.
+ */
+void SlidingWindow::stepSlide(qreal progress)
+{
+   m_motion.setProgress(progress);
+
+   if (testOption(SW_CONTROL_PANEL))
+      moveItem(qRound(m_motion.position()));
+   else
+      horizontalScrollBar()->setValue(qRound(m_motion.position()));
+}
+
 /*! \fn void SlidingWindow::moveItemFinish()
     \brief The callback function called when animation accomplished.
 
@@ -288,7 +645,9 @@ void SlidingWindow::moveItem(int offset)
  */
 void SlidingWindow::moveItemFinish()
 {
-   ;
+   /* The next slide of a benchmark starts after this one has settled. */
+   if (m_nBenchStep > 0)
+      QTimer::singleShot(0, this, SLOT(benchmarkStep()));
 
    #ifdef DEBUG
    for(int i = 0; i < sceneProxyWidgets.count(); i++)
@@ -299,7 +658,10 @@ void SlidingWindow::moveItemFinish()
 
 
 /*! \fn void SlidingWindow::slideBy(int distanceX)
-    \brief Start animation of moving items.
+    \brief Start animation of moving items, or move the end of the running one.
+
+    A button pushed while the items slide retargets them from where they
+    are, without a jump in their speed.
 
     \param[in] the distance of moving an item.
     \return NONE.
@@ -314,10 +676,14 @@ void SlidingWindow::slideBy(int distanceX)
            __LINE__, m_nNewPosOfFirstItem, itemStart, itemEnd);
    #endif
 
-   /* Set the animation frame range. */
-   m_timelineItem.setFrameRange(itemStart, itemEnd);
+   /* A new animation starts at rest, a running one goes on at its speed. */
+   if (m_timelineItem.state() != QTimeLine::NotRunning)
+      m_motion.retarget(itemEnd);
+   else
+      m_motion.start(itemStart, itemEnd, 0.0);
 
-   /* Start the timeline and start do animation. */
+   /* Start the timeline over and start do animation. */
+   m_timelineItem.stop();
    m_timelineItem.start();
 
    /* Update the latest moved distance. */
@@ -331,6 +697,64 @@ void SlidingWindow::slideBy(int distanceX)
    /* If the view reach the LEFT/RIGHT boundary,
       disable LEFT/RIGHT push button. */
    m_slideControl.pushButtonLeft->setEnabled( !(m_nNewPosOfFirstItem >= ITEM_POS_START_X) );
-   m_slideControl.pushButtonRight->setEnabled( !(m_nNewPosOfFirstItem <= -(SLIDE_OFFSET*(sceneProxyWidgets.count()-1))) );
+   m_slideControl.pushButtonRight->setEnabled( !(m_nNewPosOfFirstItem <= -(m_nSlideOffset*(sceneProxyWidgets.count()-1))) );
+}
+
+/*! \fn void SlidingWindow::goToSlide(int index, bool animate)
+    \brief Show a slide straight away, without passing the slides in between.
+
+    With the control panel, slide N is N slide offsets from the first one,
+    as slideLeft() and slideRight() step. When flicking, it is where
+    addWidget() placed it, N item widths and gaps along the scene. An
+    animated jump lands next to the slide and slides the last step only.
+
+    \param[in] index the index of the slide.
+    \param[in] animate true to slide into the slide, false to cut to it.
+    \return NONE.
+ */
+void SlidingWindow::goToSlide(int index, bool animate)
+{
+   /* The distance between two slides, as the control panel or the scroll bar moves them. */
+   int pitch = testOption(SW_CONTROL_PANEL) ? m_nSlideOffset : m_nItemWidth + m_nItemGap;
+
+   if (sceneProxyWidgets.isEmpty() || pitch <= 0)
+      return;
+
+   index = qBound(0, index, sceneProxyWidgets.count() - 1);
+
+   /* The jump replaces the running slide or flick. */
+   int current = testOption(SW_CONTROL_PANEL) ? -m_nNewPosOfFirstItem / pitch
+                                              : horizontalScrollBar()->value() / pitch;
+   m_timelineItem.stop();
+   m_flickcharm.stop(this);
+
+   int landing = index;
+   if (animate && index != current)
+      landing = (index > current) ? index - 1 : index + 1;
+
+   if (testOption(SW_CONTROL_PANEL))
+   {
+      m_nNewPosOfFirstItem = -landing * m_nSlideOffset;
+      moveItem(m_nNewPosOfFirstItem);
+
+      /* A cut starts no animation, slideBy() updates the buttons otherwise. */
+      if (landing != index)
+      {
+         slideBy((landing - index) * m_nSlideOffset);
+         return;
+      }
+
+      /* If the view reach the LEFT/RIGHT boundary, disable LEFT/RIGHT push button. */
+      m_slideControl.pushButtonLeft->setEnabled( !(m_nNewPosOfFirstItem >= ITEM_POS_START_X) );
+      m_slideControl.pushButtonRight->setEnabled( !(m_nNewPosOfFirstItem <= -(m_nSlideOffset*(sceneProxyWidgets.count()-1))) );
+      return;
+   }
+
+   horizontalScrollBar()->setValue(landing * pitch);
+
+   if (landing != index)
+   {
+      m_motion.start(landing * pitch, index * pitch, 0.0);
+      m_timelineItem.start();
+   }
 }
-#endif
@@ -16,6 +16,8 @@
 
 #include "ui_SlidingWindowControl.h"
 #include "FlickCharm/flickcharm.h"
+#include "SlideMotion.h"
+#include "FrameStats.h"
 //
 #include "Apps/DigiFlip/digiflip.h"
 #include "Apps/DigitalClock/digitalclock.h"
@@ -23,6 +25,26 @@
 #include "Apps/Wiggly/dialog.h"
 #include "Apps/ParallaxHome/parallaxhome.h"
 
+/*! \enum SlidingWindowOption
+    \brief The features of the sliding window which can be switched at runtime.
+*/
+enum SlidingWindowOption{
+    SW_TRANSPARENT_FRAME = 0x01,  /*!< Transparent window frame, needs a compositing manager. */
+    SW_CONTROL_PANEL = 0x02       /*!< Slide with the control panel instead of flicking. */
+};
+
+/* The features of the sliding window by default. */
+#define DFLT_SLIDING_WINDOW_OPTIONS  (SW_TRANSPARENT_FRAME)
+
+/*! \enum RenderProfile
+    \brief The named sets of viewport update mode, optimization flags, cache mode and render hints.
+*/
+enum RenderProfile{
+    RENDER_DEFAULT = 0,  /*!< Qt's defaults. */
+    RENDER_LOW_POWER,    /*!< The fewest CPU cycles per frame, e.g. for embedded devices. */
+    RENDER_QUALITY       /*!< Antialiased and smoothly transformed drawing. */
+};
+
 /*! \class SlidingWindow
     \brief The sliding window class.
 */
@@ -31,7 +53,14 @@ class SlidingWindow : public QGraphicsView
 Q_OBJECT
 
 public:
-    SlidingWindow();  /*!< Constructor */
+    SlidingWindow(int options = DFLT_SLIDING_WINDOW_OPTIONS);  /*!< Constructor */
+
+    bool testOption(SlidingWindowOption option) const;  /*!< Whether a feature is switched on. */
+
+    void setRenderProfile(RenderProfile profile);  /*!< Tune the views for power or quality. */
+    RenderProfile renderProfile() const;
+    static QString renderProfileName(RenderProfile profile);  /*!< The name of a profile in the layout file. */
+    static RenderProfile renderProfileFromName(const QString &name, bool *ok = 0);
 
 private:
     QGraphicsScene scene;  /*!< The canvas */
@@ -39,15 +68,14 @@ private:
     QList<QWidget*> slideItems;  /*!< The list of items of QGraphicsItem type.  */
     QList<QGraphicsProxyWidget*> sceneProxyWidgets;
 
-    #ifdef USE_CONTROL_PANEL
+    int m_nOptions;  /*!< The switched on features, OR-ed SlidingWindowOption values. */
+
     QTimeLine m_timelineItem;  /*!< The timeline for sliding items. */
+    SlideMotion m_motion;      /*!< The path of the running slide, retargeted by new slides. */
     Ui::ControlPanelForm m_slideControl;  /*!< The form constructed from UI designer. */
     int m_nNewPosOfFirstItem;  /*!< The current starting position of X-axis. */
-    #endif
 
-    #ifndef USE_CONTROL_PANEL
-    FlickCharm m_flickcharm;
-    #endif
+    FlickCharm m_flickcharm;  /*!< Only activated when the control panel is not used. */
 
     /* QWidget/App items */
     DigiFlip     *m_flipClock;
@@ -56,26 +84,44 @@ private:
     WigglyText   *m_wigglyText;
     ParallaxHome *m_parallaxHome;
 
+    /* The slide layout, see loadLayout(). */
+    int m_nItemWidth;          /*!< The width of each widget item. */
+    int m_nItemGap;            /*!< The gap between two widget items. */
+    int m_nSlideOffset;        /*!< The moving offset of one slide. */
+    int m_nAnimationDuration;  /*!< The duration of the slide animation in milliseconds. */
+
+    RenderProfile m_renderProfile;  /*!< The rendering profile of the views. */
+    bool m_bReportFrameTime;        /*!< Print the painting time of the frames. */
+    FrameStats m_frameStats;        /*!< The painting times since the last report. */
+    FrameStats m_benchStats;        /*!< The painting times of the running benchmark. */
+    QElapsedTimer m_benchClock;     /*!< The duration of the running benchmark. */
+    int m_nBenchSweeps;             /*!< The sweeps of the running benchmark. */
+    int m_nBenchStep;               /*!< The next slide of the running benchmark, -1 when not running. */
+
 public:
-    #ifdef USE_CONTROL_PANEL
     void slideBy(int distanceX);
-    #endif
+    void goToSlide(int index, bool animate = true);  /*!< Show a slide without passing the ones in between. */
     void addWidgetItem(QWidget* widget);
+    void startBenchmark(int sweeps);  /*!< Slide through all slides and back, then report the painting times. */
 
 protected:
+    QSize loadLayout();  /*!< Load the window geometry and slide layout. */
     void addDefaultWidgetItems();  /*!< Add default widges into sliding window */
+    void resizeEvent(QResizeEvent *event);
+    void paintEvent(QPaintEvent *event);
+
+signals:
+    void benchmarkFinished(const QString &summary);  /*!< The painting times of the benchmark. */
 
 public slots:
-    #ifdef USE_CONTROL_PANEL
     /* The event handlers for sliding item event. */
     void slideLeft();
     void slideRight();
-    #endif
 
 private slots:
-    #ifdef USE_CONTROL_PANEL
     void moveItem(int nOffset);  /*!< For moving items. */
+    void stepSlide(qreal progress);  /*!< Move the items along the running slide. */
     void moveItemFinish();
-    #endif
+    void benchmarkStep();  /*!< Slide to the next slide of the benchmark, or report it. */
 };
 #endif /* SlidingWindow_H */
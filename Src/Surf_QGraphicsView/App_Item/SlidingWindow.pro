@@ -10,6 +10,9 @@ INCLUDEPATH += . FlickCharm
 
 # Input
 HEADERS += SlidingWindow.h \
+           SlideBenchmark.h \
+           SlideMotion.h \
+           FrameStats.h \
            FlickCharm/flickcharm.h \
            Apps/DigiFlip/digiflip.h \
            Apps/DigitalClock/digitalclock.h \
@@ -22,6 +25,9 @@ FORMS += SlidingWindowControl.ui
 
 SOURCES += main.cpp \
            SlidingWindow.cpp \
+           SlideBenchmark.cpp \
+           SlideMotion.cpp \
+           FrameStats.cpp \
            FlickCharm/flickcharm.cpp \
            Apps/DigiFlip/digiflip.cpp \
            Apps/DigitalClock/digitalclock.cpp \
@@ -32,11 +38,15 @@ SOURCES += main.cpp \
 
 RESOURCES = Apps/ParallaxHome/parallaxhome.qrc
 
-DEFINES += ENABLE_TRANSPARENT_FRAME
-#DEFINES += USE_CONTROL_PANEL
-
 QT += gui
 QT += svg
 # Added for Qt5, 2015-09-10. Begin
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 # Added for Qt5, 2015-09-10. End
+
+# Qt5 asks X11 through QtX11Extras whether a compositing manager runs, see isCompositingManagerRunning().
+greaterThan(QT_MAJOR_VERSION, 4):unix:!macx:qtHaveModule(x11extras) {
+    QT += x11extras
+    DEFINES += HAVE_X11EXTRAS
+    lessThan(QT_MINOR_VERSION, 7): LIBS += -lxcb
+}
@@ -0,0 +1,19 @@
+######################################################################
+# The offline slide bundler, see SlideBundle.h.
+# Usage: SlideBundler <image folder> <bundle file> [width height]
+######################################################################
+
+TEMPLATE = app
+TARGET = SlideBundler
+CONFIG += console
+CONFIG -= app_bundle
+
+DEPENDPATH += . ..
+INCLUDEPATH += . ..
+
+# Input
+HEADERS += ../SlideBundle.h ../ImageScaler.h ../ExifReader.h
+SOURCES += main.cpp ../SlideBundle.cpp ../ImageScaler.cpp ../ExifReader.cpp
+
+QT += gui
+greaterThan(QT_MAJOR_VERSION, 4): QT += concurrent
@@ -0,0 +1,146 @@
+/*! \file main.cpp
+    \brief The main entry of the slide bundler, packing an image folder into a slide bundle.
+ */
+
+#include <QtGlobal>
+#include <QCoreApplication>
+#include <QDir>
+#include <QImageReader>
+#include <QStringList>
+#include <QThread>
+#include <QTime>
+
+#if QT_VERSION < 0x050000
+#include <QtConcurrentMap>
+#else
+#include <QtConcurrent/QtConcurrentMap>
+#endif
+
+#include "SlideBundle.h"
+#include "ImageScaler.h"
+#include "ExifReader.h"
+
+/* The default window size of the sliding window. */
+#define DFLT_TARGET_WIDTH  1024
+#define DFLT_TARGET_HEIGHT  600
+
+/* The slides prepared at once per core, bounding the memory held before writing them. */
+#define SLIDES_PER_CORE  2
+
+/*! \struct SlidePreparer
+    \brief Decode, turn upright and scale a picture for the target window, on a worker thread.
+*/
+struct SlidePreparer
+{
+    typedef QImage result_type;
+
+    QSize target;  /*!< The window size. */
+
+    QImage operator()(const QString &fileName) const
+    {
+       ExifReader exif(fileName);
+       QImageReader reader(fileName);
+
+       #if QT_VERSION >= 0x050500
+       reader.setAutoTransform(false);  /* Turned upright below, once scaled. */
+       #endif
+
+       QImage image = reader.read();
+       if (image.isNull())
+          return image;
+
+       /* Fit the upright picture as SlidingWindow::addImages() does: each side
+          larger than the window is shrunk to it, independently. */
+       bool transposed = ExifReader::isTransposed(exif.orientation());
+       QSize size = image.size();
+       if (transposed)
+          size.transpose();
+
+       size = size.boundedTo(target);
+       if (transposed)
+          size.transpose();
+
+       /* Each worker prepares its own picture, so scale on this thread only. */
+       image = ImageScaler::scaled(image, size, false);
+
+       if (exif.orientation() != 1)
+          image = image.transformed(ExifReader::orientationTransform(exif.orientation()));
+
+       return image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    }
+};
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+
+    if (args.count() != 3 && args.count() != 5)
+    {
+       qDebug("Usage: %s <image folder> <bundle file> [width height]", argv[0]);
+       return 1;
+    }
+
+    SlidePreparer preparer;
+    preparer.target = QSize(DFLT_TARGET_WIDTH, DFLT_TARGET_HEIGHT);
+    if (args.count() == 5)
+       preparer.target = QSize(args.at(3).toInt(), args.at(4).toInt());
+
+    if (preparer.target.isEmpty())
+    {
+       qDebug("Invalid window size!!!");
+       return 1;
+    }
+
+    /* The same pictures in the same order as SlidingWindow::addImages() finds them. */
+    QDir imgDir(args.at(1));
+    QStringList nameFilters;
+    nameFilters << "*.png" << "*.jpg" << "*.jpeg";
+    imgDir.setNameFilters(nameFilters);
+    imgDir.setFilter(QDir::Files);
+    imgDir.setSorting(QDir::Name);
+
+    QStringList fileNames;
+    foreach (const QString &name, imgDir.entryList())
+       fileNames << imgDir.filePath(name);
+
+    if (fileNames.isEmpty())
+    {
+       qDebug("No pictures in %s!!!", qPrintable(args.at(1)));
+       return 1;
+    }
+
+    QTime timer;
+    timer.start();
+
+    SlideBundleWriter writer(args.at(2), preparer.target, fileNames.count());
+    const int chunk = qMax(1, QThread::idealThreadCount()) * SLIDES_PER_CORE;
+
+    for (int i = 0; i < fileNames.count(); i += chunk)
+    {
+       QList<QImage> slides = QtConcurrent::blockingMapped<QList<QImage> >(fileNames.mid(i, chunk), preparer);
+
+       for (int j = 0; j < slides.count(); j++)
+       {
+          if (slides.at(j).isNull())
+             qDebug("Cannot decode %s, it is left empty.", qPrintable(fileNames.at(i + j)));
+
+          if (!writer.addSlide(slides.at(j)))
+          {
+             qDebug("Cannot write %s!!!", qPrintable(args.at(2)));
+             return 1;
+          }
+       }
+    }
+
+    if (!writer.finish())
+    {
+       qDebug("Cannot write %s!!!", qPrintable(args.at(2)));
+       return 1;
+    }
+
+    qDebug("%d slides for %dx%d written to %s in %d ms", fileNames.count(),
+           preparer.target.width(), preparer.target.height(), qPrintable(args.at(2)), timer.elapsed());
+
+    return 0;
+}
@@ -0,0 +1,404 @@
+/*! \file  DeepZoomView.cpp
+    \brief Implementation of DeepZoomView class.
+ */
+
+#include <QtGlobal>
+
+#if QT_VERSION >= 0x050000
+#include <QtWidgets/QGestureEvent>
+#include <QtWidgets/QPinchGesture>
+#else
+#include <QGestureEvent>
+#include <QPinchGesture>
+#endif
+
+#include <QPainter>
+#include <QMouseEvent>
+#include <QWheelEvent>
+#include <QResizeEvent>
+#include <QMultiMap>
+#include <qmath.h>
+
+#include "DeepZoomView.h"
+#include "TilePyramid.h"
+#include "ExifReader.h"
+
+#define DEEP_ZOOM_MAX_SCALE   2.0   /* The picture is zoomed up to twice its pixels. */
+#define DEEP_ZOOM_FALLBACK_LEVELS  3  /* The coarser levels searched for a missing tile. */
+
+/*! \fn DeepZoomView::DeepZoomView(const QString &cacheDir, int cacheMBytes, int bufferKBytes, QWidget *parent)
+    \brief Constructor
+
+    \param[in] cacheDir the folder of all pyramids.
+    \param[in] cacheMBytes the disk space of all pyramids.
+    \param[in] bufferKBytes the memory for a band of the picture while building its pyramid.
+    \param[in] parent the parent widget, the sliding window.
+ */
+DeepZoomView::DeepZoomView(const QString &cacheDir, int cacheMBytes, int bufferKBytes, QWidget *parent)
+    : QWidget(parent)
+    , m_loader(cacheDir, cacheMBytes, bufferKBytes)
+    , m_nMaxKBytes(0)
+    , m_nLevels(0)
+    , m_scale(1.0)
+    , m_fitScale(1.0)
+    , m_bPanning(false)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    grabGesture(Qt::PinchGesture);
+
+    QObject::connect(&m_loader, SIGNAL(pyramidReady(QSize, int, int)), this, SLOT(pyramidReady(QSize, int, int)));
+    QObject::connect(&m_loader, SIGNAL(tileLoaded(int, int, int, QImage)), this, SLOT(tileLoaded(int, int, int, QImage)));
+
+    hide();
+}
+
+/*! \fn void DeepZoomView::open(const QString &fileName, const QImage &slide, const QSize &size)
+    \brief Show a picture as its slide shows it, ready to zoom in; its pyramid is built if not cached.
+
+    \param[in] fileName the picture file.
+    \param[in] slide the slide of the picture, shown until the tiles are read.
+    \param[in] size the size of the picture, upright.
+    \return NONE.
+ */
+void DeepZoomView::open(const QString &fileName, const QImage &slide, const QSize &size)
+{
+    if (fileName != m_fileName)
+    {
+       m_fileName = fileName;
+       m_tiles.clear();
+       m_lastRequest.clear();
+       m_nLevels = 0;
+       m_loader.setImage(fileName);
+    }
+
+    m_slide = slide;
+    m_imageSize = size;
+    m_fitScale = (size.width() > 0) ? static_cast<qreal>(slide.width()) / size.width() : 1.0;
+    m_scale = m_fitScale;
+    m_bPanning = false;
+    boundOrigin();
+
+    show();
+    raise();
+    update();
+}
+
+/*! \fn void DeepZoomView::zoomBy(qreal factor, const QPointF &center)
+    \brief Zoom around a point of the view, which stays on the same picture point; zooming out to the slide closes the view.
+
+    \param[in] factor the zoom, above 1 to zoom in.
+    \param[in] center the point of the view.
+    \return NONE.
+ */
+void DeepZoomView::zoomBy(qreal factor, const QPointF &center)
+{
+    if (m_imageSize.isEmpty() || factor <= 0)
+       return;
+
+    QPointF point = m_origin + center / m_scale;
+
+    m_scale = qBound(m_fitScale, m_scale * factor, qMax(m_fitScale, static_cast<qreal>(DEEP_ZOOM_MAX_SCALE)));
+    m_origin = point - center / m_scale;
+    boundOrigin();
+
+    if (m_scale <= m_fitScale && factor < 1)
+       zoomOut();
+    else
+       update();
+}
+
+/*! \fn void DeepZoomView::setMaxKBytes(int kbytes)
+    \brief Set the memory for the tiles read lately, never below a view of tiles.
+
+    \param[in] kbytes the budget in KB.
+    \return NONE.
+ */
+void DeepZoomView::setMaxKBytes(int kbytes)
+{
+    const int edge = TILE_PYRAMID_TILE_SIZE;
+    int viewKBytes = (width() / edge + 2) * (height() / edge + 2) * (edge * edge * 4 / 1024);
+
+    m_nMaxKBytes = kbytes;
+    m_tiles.setMaxCost(qMax(kbytes, viewKBytes));
+}
+
+/*! \fn void DeepZoomView::pyramidReady(const QSize &size, int orientation, int levels)
+    \brief Start drawing the tiles once the pyramid of the picture is open.
+
+    \param[in] size the size of the picture as stored.
+    \param[in] orientation the EXIF orientation of the picture.
+    \param[in] levels the levels of the pyramid, 0 if it could not be built.
+    \return NONE.
+ */
+void DeepZoomView::pyramidReady(const QSize &size, int orientation, int levels)
+{
+    m_storedSize = size;
+    m_storedToUpright = QImage::trueMatrix(ExifReader::orientationTransform(orientation), size.width(), size.height());
+    m_nLevels = levels;
+
+    update();
+}
+
+/*! \fn void DeepZoomView::tileLoaded(int level, int column, int row, const QImage &tile)
+    \brief Keep a tile read by the loader and draw it.
+
+    \param[in] level the level of the tile.
+    \param[in] column the column of the tile in its level.
+    \param[in] row the row of the tile in its level.
+    \param[in] tile the tile, null if it could not be read; it is kept so it is not read again.
+    \return NONE.
+ */
+void DeepZoomView::tileLoaded(int level, int column, int row, const QImage &tile)
+{
+    quint64 key = TilePyramid::tileKey(level, column, row);
+
+    m_tiles.insert(key, new QImage(tile), qMax(1, tile.byteCount() / 1024));
+    m_lastRequest.removeAll(key);
+    update();
+}
+
+/*! \fn bool DeepZoomView::event(QEvent *event)
+    \brief Zoom with a pinch.
+
+    \param[in] QEvent object.
+    \return true if the event was handled.
+ */
+bool DeepZoomView::event(QEvent *event)
+{
+    if (event->type() == QEvent::Gesture)
+    {
+       QPinchGesture *pinch = static_cast<QPinchGesture*>(static_cast<QGestureEvent*>(event)->gesture(Qt::PinchGesture));
+
+       if (pinch != NULL && (pinch->changeFlags() & QPinchGesture::ScaleFactorChanged))
+          zoomBy(pinch->scaleFactor(), mapFromGlobal(pinch->centerPoint().toPoint()));
+
+       return true;
+    }
+
+    return QWidget::event(event);
+}
+
+/*! \fn void DeepZoomView::paintEvent(QPaintEvent *event)
+    \brief Draw the tiles under the view at the level of the zoom, and request the missing ones.
+
+    \param[in] QPaintEvent object.
+    \return NONE.
+ */
+void DeepZoomView::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::black);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+
+    /* The picture point of the top-left of the view at the view origin, scaled. */
+    QTransform view = QTransform::fromTranslate(-m_origin.x(), -m_origin.y()) * QTransform::fromScale(m_scale, m_scale);
+
+    /* The slide under everything, the tiles cover it as they arrive. */
+    painter.setTransform(view);
+    painter.drawImage(QRectF(QPointF(0, 0), QSizeF(m_imageSize)), m_slide);
+
+    if (m_nLevels <= 0)
+       return;
+
+    /* The tiles are stored as the picture is, turned upright when drawn. */
+    QTransform toView = m_storedToUpright * view;
+    painter.setTransform(toView);
+
+    const int edge = TILE_PYRAMID_TILE_SIZE;
+    int level = qBound(0, qFloor(qLn(1.0 / m_scale) / qLn(2.0)), m_nLevels - 1);
+    int span = edge << level;  /* The picture pixels a tile of the level covers. */
+    QRect visible = toView.inverted().mapRect(QRectF(rect())).toAlignedRect() & QRect(QPoint(0, 0), m_storedSize);
+    QMultiMap<int, quint64> missing;  /* By the distance to the middle of the view. */
+
+    if (visible.isEmpty())
+       return;
+
+    for (int row = visible.top() / span; row <= visible.bottom() / span; row++)
+    {
+       for (int column = visible.left() / span; column <= visible.right() / span; column++)
+       {
+          quint64 key = TilePyramid::tileKey(level, column, row);
+          QImage *tile = m_tiles.object(key);
+
+          if (tile != NULL && !tile->isNull())
+          {
+             painter.drawImage(QRectF(column * span, row * span, tile->width() << level, tile->height() << level), *tile);
+             continue;
+          }
+
+          if (tile == NULL)
+          {
+             QPointF middle = toView.map(QPointF((column + 0.5) * span, (row + 0.5) * span));
+             missing.insert((middle - QPointF(rect().center())).toPoint().manhattanLength(), key);
+          }
+
+          drawCoarser(painter, level, column, row);
+       }
+    }
+
+    QList<quint64> request = missing.values();
+    if (request != m_lastRequest)
+    {
+       m_loader.request(request);
+       m_lastRequest = request;
+    }
+}
+
+/*! \fn bool DeepZoomView::drawCoarser(QPainter &painter, int level, int column, int row)
+    \brief Draw the area of a missing tile from a coarser level already read.
+
+    \param[in] painter the painter, in stored picture coordinates.
+    \param[in] level the level of the missing tile.
+    \param[in] column the column of the missing tile in its level.
+    \param[in] row the row of the missing tile in its level.
+    \return true if a coarser tile was drawn.
+ */
+bool DeepZoomView::drawCoarser(QPainter &painter, int level, int column, int row)
+{
+    const int edge = TILE_PYRAMID_TILE_SIZE;
+    QRectF area(column * (edge << level), row * (edge << level), edge << level, edge << level);
+
+    for (int coarser = level + 1; coarser < qMin(m_nLevels, level + 1 + DEEP_ZOOM_FALLBACK_LEVELS); coarser++)
+    {
+       int shift = coarser - level;
+       QImage *tile = m_tiles.object(TilePyramid::tileKey(coarser, column >> shift, row >> shift));
+
+       if (tile == NULL || tile->isNull())
+          continue;
+
+       /* The part of the coarser tile over the missing one, in its pixels. */
+       qreal scale = 1 << coarser;
+       QPointF corner((column >> shift) * edge * scale, (row >> shift) * edge * scale);
+       QRectF source(QPointF((area.left() - corner.x()) / scale, (area.top() - corner.y()) / scale), area.size() / scale);
+       source &= QRectF(tile->rect());
+
+       if (!source.isEmpty())
+          painter.drawImage(QRectF(corner + source.topLeft() * scale, source.size() * scale), *tile, source);
+
+       return true;
+    }
+
+    return false;
+}
+
+/*! \fn void DeepZoomView::boundOrigin()
+    \brief Keep the picture over the view, or centered in it when smaller.
+
+    \param[in] NONE.
+    \return NONE.
+ */
+void DeepZoomView::boundOrigin()
+{
+    QSizeF extent(width() / m_scale, height() / m_scale);
+
+    if (m_imageSize.width() <= extent.width())
+       m_origin.setX((m_imageSize.width() - extent.width()) / 2);
+    else
+       m_origin.setX(qBound(static_cast<qreal>(0), m_origin.x(), m_imageSize.width() - extent.width()));
+
+    if (m_imageSize.height() <= extent.height())
+       m_origin.setY((m_imageSize.height() - extent.height()) / 2);
+    else
+       m_origin.setY(qBound(static_cast<qreal>(0), m_origin.y(), m_imageSize.height() - extent.height()));
+}
+
+/*! \fn void DeepZoomView::zoomOut()
+    \brief Hide the view, the slide it started from shows again.
+
+    \param[in] NONE.
+    \return NONE.
+ */
+void DeepZoomView::zoomOut()
+{
+    bool wasVisible = isVisible();
+
+    m_bPanning = false;
+    m_loader.request(QList<quint64>());
+    m_lastRequest.clear();
+    hide();
+
+    if (wasVisible)
+       emit closed();
+}
+
+/*! \fn void DeepZoomView::resizeEvent(QResizeEvent *event)
+    \brief Keep the picture over the view, and a view of tiles in the cache.
+
+    \param[in] QResizeEvent object.
+    \return NONE.
+ */
+void DeepZoomView::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+
+    setMaxKBytes(m_nMaxKBytes);
+    boundOrigin();
+}
+
+/*! \fn void DeepZoomView::wheelEvent(QWheelEvent *event)
+    \brief Zoom around the pointer with the wheel.
+
+    \param[in] QWheelEvent object.
+    \return NONE.
+ */
+void DeepZoomView::wheelEvent(QWheelEvent *event)
+{
+    zoomBy(qPow(DEEP_ZOOM_WHEEL_STEP, event->delta() / 120.0), event->pos());
+}
+
+/*! \fn void DeepZoomView::mousePressEvent(QMouseEvent *event)
+    \brief Start panning the picture.
+
+    \param[in] QMouseEvent object.
+    \return NONE.
+ */
+void DeepZoomView::mousePressEvent(QMouseEvent *event)
+{
+    m_bPanning = true;
+    m_lastPos = event->pos();
+}
+
+/*! \fn void DeepZoomView::mouseMoveEvent(QMouseEvent *event)
+    \brief Pan the picture with the pointer.
+
+    \param[in] QMouseEvent object.
+    \return NONE.
+ */
+void DeepZoomView::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!m_bPanning)
+       return;
+
+    m_origin -= QPointF(event->pos() - m_lastPos) / m_scale;
+    m_lastPos = event->pos();
+    boundOrigin();
+    update();
+}
+
+/*! \fn void DeepZoomView::mouseReleaseEvent(QMouseEvent *event)
+    \brief Stop panning the picture.
+
+    \param[in] QMouseEvent object.
+    \return NONE.
+ */
+void DeepZoomView::mouseReleaseEvent(QMouseEvent *event)
+{
+    Q_UNUSED(event);
+
+    m_bPanning = false;
+}
+
+/*! \fn void DeepZoomView::mouseDoubleClickEvent(QMouseEvent *event)
+    \brief Go back to the slide.
+
+    \param[in] QMouseEvent object.
+    \return NONE.
+ */
+void DeepZoomView::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    Q_UNUSED(event);
+
+    zoomOut();
+}
@@ -0,0 +1,88 @@
+/*! \file  DeepZoomView.h
+    \brief Declaration of DeepZoomView class.
+ */
+
+#ifndef DEEPZOOMVIEW_H
+#define DEEPZOOMVIEW_H
+
+#include <QtGlobal>
+
+#if QT_VERSION >= 0x050000
+#include <QtWidgets/QWidget>
+#else
+#include <QWidget>
+#endif
+
+#include <QCache>
+#include <QImage>
+#include <QList>
+#include <QPointF>
+#include <QTransform>
+
+#include "TileLoader.h"
+
+#define DEEP_ZOOM_WHEEL_STEP  1.25  /* The zoom of a wheel notch. */
+
+class QPainter;
+
+/*! \class DeepZoomView
+    \brief The view of a picture zoomed in beyond its slide, drawn from the tiles of its pyramid.
+
+    Only the tiles under the view are drawn, from the level matching the
+    zoom, and the missing ones are read in the background, the nearest to
+    the middle first. Until a tile arrives, its area shows a coarser level
+    or the slide, so the view never waits for the disk.
+*/
+class DeepZoomView : public QWidget
+{
+Q_OBJECT
+
+public:
+    DeepZoomView(const QString &cacheDir, int cacheMBytes, int bufferKBytes, QWidget *parent = 0);  /*!< Constructor */
+
+    void open(const QString &fileName, const QImage &slide, const QSize &size);  /*!< Show a picture as its slide shows it. */
+    void zoomBy(qreal factor, const QPointF &center);  /*!< Zoom around a point of the view. */
+    void setMaxKBytes(int kbytes);  /*!< The memory for the tiles, at least a view of them. */
+    void zoomOut();  /*!< Hide the view, the slide shows again. */
+
+signals:
+    void closed();  /*!< Zoomed out to the slide again. */
+
+protected:
+    bool event(QEvent *event);
+    void paintEvent(QPaintEvent *event);
+    void resizeEvent(QResizeEvent *event);
+    void wheelEvent(QWheelEvent *event);
+    void mousePressEvent(QMouseEvent *event);
+    void mouseMoveEvent(QMouseEvent *event);
+    void mouseReleaseEvent(QMouseEvent *event);
+    void mouseDoubleClickEvent(QMouseEvent *event);
+
+private slots:
+    void pyramidReady(const QSize &size, int orientation, int levels);
+    void tileLoaded(int level, int column, int row, const QImage &tile);
+
+private:
+    bool drawCoarser(QPainter &painter, int level, int column, int row);
+    void boundOrigin();
+
+    TileLoader m_loader;
+    QString m_fileName;               /*!< The picture shown, its tiles are kept when it is opened again. */
+    QCache<quint64, QImage> m_tiles;  /*!< The tiles read lately, by TilePyramid::tileKey(), costed in KB. */
+    QList<quint64> m_lastRequest;     /*!< The tiles last requested to the loader. */
+    int m_nMaxKBytes;                 /*!< The configured budget of m_tiles. */
+
+    QImage m_slide;             /*!< The slide of the picture, shown under the missing tiles. */
+    QSize m_imageSize;          /*!< The size of the picture, upright. */
+    QSize m_storedSize;         /*!< The size of the picture as stored, and tiled. */
+    QTransform m_storedToUpright;
+    int m_nLevels;              /*!< 0 until the pyramid is ready. */
+
+    qreal m_scale;              /*!< The view pixels per picture pixel. */
+    qreal m_fitScale;           /*!< The scale of the slide, zooming out to it closes the view. */
+    QPointF m_origin;           /*!< The picture point at the top-left of the view. */
+    QPoint m_lastPos;
+    bool m_bPanning;
+};
+
+#endif /* DEEPZOOMVIEW_H */
@@ -0,0 +1,230 @@
+/*! \file  ExifReader.cpp
+    \brief Implementation of ExifReader class.
+ */
+
+#include <QFile>
+#include <QtGlobal>
+
+#include "ExifReader.h"
+
+/* The JPEG markers. */
+#define JPEG_SOI   0xD8  /* Start of image. */
+#define JPEG_SOS   0xDA  /* Start of scan, the compressed picture follows. */
+#define JPEG_APP1  0xE1
+
+/* The TIFF tags. */
+#define TAG_ORIENTATION        0x0112  /* IFD0, SHORT. */
+#define TAG_THUMBNAIL_OFFSET   0x0201  /* IFD1, LONG, JPEGInterchangeFormat. */
+#define TAG_THUMBNAIL_LENGTH   0x0202  /* IFD1, LONG, JPEGInterchangeFormatLength. */
+
+#define IFD_ENTRY_SIZE  12
+
+/*! \fn ExifReader::ExifReader(const QString &fileName)
+    \brief Constructor, read the EXIF data of a JPEG file.
+
+    \param[in] fileName the picture file.
+ */
+ExifReader::ExifReader(const QString &fileName)
+    : m_bBigEndian(false)
+    , m_nOrientation(1)
+{
+    QFile file(fileName);
+    if (file.open(QIODevice::ReadOnly))
+       readSegments(&file);
+}
+
+/*! \fn ExifReader::ExifReader(QIODevice *device)
+    \brief Constructor, read the EXIF data of a JPEG stream, e.g. a mapped file in a QBuffer.
+
+    \param[in] device the stream, positioned at its start.
+ */
+ExifReader::ExifReader(QIODevice *device)
+    : m_bBigEndian(false)
+    , m_nOrientation(1)
+{
+    readSegments(device);
+}
+
+/*! \fn void ExifReader::readSegments(QIODevice *device)
+    \brief Walk the segments of a JPEG stream until the EXIF APP1 one.
+
+    \param[in] device the stream, positioned at its start.
+    \return NONE.
+ */
+void ExifReader::readSegments(QIODevice *device)
+{
+    QByteArray soi = device->read(2);
+    if (soi.size() != 2 || (uchar)soi[0] != 0xFF || (uchar)soi[1] != JPEG_SOI)
+       return;
+
+    /* Each segment is a 0xFF marker byte, a marker and a big-endian length including itself. */
+    forever
+    {
+       QByteArray header = device->read(4);
+       if (header.size() != 4 || (uchar)header[0] != 0xFF || (uchar)header[1] == JPEG_SOS)
+          return;
+
+       int length = ((uchar)header[2] << 8) | (uchar)header[3];
+       if (length < 2)
+          return;
+
+       if ((uchar)header[1] != JPEG_APP1)
+       {
+          if (!device->seek(device->pos() + length - 2))
+             return;
+          continue;
+       }
+
+       QByteArray segment = device->read(length - 2);
+       if (segment.startsWith(QByteArray("Exif\0\0", 6)))
+       {
+          parse(segment.mid(6));
+          return;
+       }
+    }
+}
+
+/*! \fn void ExifReader::parse(const QByteArray &tiff)
+    \brief Find the orientation in IFD0 and the thumbnail in IFD1 of the TIFF structure.
+
+    \param[in] tiff the APP1 segment following the "Exif" identifier.
+    \return NONE.
+ */
+void ExifReader::parse(const QByteArray &tiff)
+{
+    if (tiff.size() < 8 || (!tiff.startsWith("MM") && !tiff.startsWith("II")))
+       return;
+
+    m_bBigEndian = tiff.startsWith("MM");
+
+    quint32 ifd0 = readLong(tiff, 4);
+    if (ifd0 + 2 > (quint32)tiff.size())
+       return;
+
+    int entries = readShort(tiff, ifd0);
+    for (int i = 0; i < entries; i++)
+    {
+       int entry = ifd0 + 2 + i * IFD_ENTRY_SIZE;
+       if (entry + IFD_ENTRY_SIZE > tiff.size())
+          return;
+
+       if (readShort(tiff, entry) == TAG_ORIENTATION)
+       {
+          int orientation = readShort(tiff, entry + 8);
+          if (orientation >= 1 && orientation <= 8)
+             m_nOrientation = orientation;
+       }
+    }
+
+    /* The offset of IFD1 follows the entries of IFD0. */
+    quint32 ifd1 = readLong(tiff, ifd0 + 2 + entries * IFD_ENTRY_SIZE);
+    if (ifd1 == 0 || ifd1 + 2 > (quint32)tiff.size())
+       return;
+
+    quint32 offset = 0, length = 0;
+    entries = readShort(tiff, ifd1);
+    for (int i = 0; i < entries; i++)
+    {
+       int entry = ifd1 + 2 + i * IFD_ENTRY_SIZE;
+       if (entry + IFD_ENTRY_SIZE > tiff.size())
+          break;
+
+       if (readShort(tiff, entry) == TAG_THUMBNAIL_OFFSET)
+          offset = readLong(tiff, entry + 8);
+       else if (readShort(tiff, entry) == TAG_THUMBNAIL_LENGTH)
+          length = readLong(tiff, entry + 8);
+    }
+
+    if (offset > 0 && length > 0 && offset + length <= (quint32)tiff.size())
+       m_thumbnail = tiff.mid(offset, length);
+}
+
+/*! \fn quint16 ExifReader::readShort(const QByteArray &tiff, int offset) const
+    \brief Read a SHORT in the byte order of the TIFF structure.
+
+    \param[in] tiff the TIFF structure.
+    \param[in] offset the position of the value.
+    \return the value, 0 past the end.
+ */
+quint16 ExifReader::readShort(const QByteArray &tiff, int offset) const
+{
+    if (offset < 0 || offset + 2 > tiff.size())
+       return 0;
+
+    const uchar *p = reinterpret_cast<const uchar *>(tiff.constData()) + offset;
+
+    return m_bBigEndian ? (p[0] << 8) | p[1] : (p[1] << 8) | p[0];
+}
+
+/*! \fn quint32 ExifReader::readLong(const QByteArray &tiff, int offset) const
+    \brief Read a LONG in the byte order of the TIFF structure.
+
+    \param[in] tiff the TIFF structure.
+    \param[in] offset the position of the value.
+    \return the value, 0 past the end.
+ */
+quint32 ExifReader::readLong(const QByteArray &tiff, int offset) const
+{
+    if (offset < 0 || offset + 4 > tiff.size())
+       return 0;
+
+    return m_bBigEndian ? ((quint32)readShort(tiff, offset) << 16) | readShort(tiff, offset + 2)
+                        : ((quint32)readShort(tiff, offset + 2) << 16) | readShort(tiff, offset);
+}
+
+/*! \fn int ExifReader::orientation() const
+    \brief Return the EXIF orientation of the picture.
+
+    \param[in] NONE.
+    \return 1 (upright) to 8, 1 without EXIF data.
+ */
+int ExifReader::orientation() const
+{
+    return m_nOrientation;
+}
+
+/*! \fn QImage ExifReader::thumbnail() const
+    \brief Decode the embedded thumbnail, it is not turned upright.
+
+    \param[in] NONE.
+    \return the thumbnail, null if the file has none.
+ */
+QImage ExifReader::thumbnail() const
+{
+    if (m_thumbnail.isEmpty())
+       return QImage();
+
+    return QImage::fromData(m_thumbnail, "JPEG");
+}
+
+/*! \fn QTransform ExifReader::orientationTransform(int orientation)
+    \brief Return the transform turning a picture of an EXIF orientation upright.
+
+    \param[in] orientation the EXIF orientation.
+    \return the transform, for QImage::transformed().
+ */
+QTransform ExifReader::orientationTransform(int orientation)
+{
+    switch (orientation)
+    {
+    case 2: return QTransform(-1, 0, 0, 1, 0, 0);   /* Mirrored horizontally. */
+    case 3: return QTransform(-1, 0, 0, -1, 0, 0);  /* Rotated 180 degrees. */
+    case 4: return QTransform(1, 0, 0, -1, 0, 0);   /* Mirrored vertically. */
+    case 5: return QTransform(0, 1, 1, 0, 0, 0);    /* Transposed. */
+    case 6: return QTransform(0, 1, -1, 0, 0, 0);   /* Rotated 90 degrees clockwise to be upright. */
+    case 7: return QTransform(0, -1, -1, 0, 0, 0);  /* Transversed. */
+    case 8: return QTransform(0, -1, 1, 0, 0, 0);   /* Rotated 90 degrees counterclockwise to be upright. */
+    default: return QTransform();
+    }
+}
+
+/*! \fn bool ExifReader::isTransposed(int orientation)
+    \brief Check if the width and height of a picture of an EXIF orientation swap when it is upright.
+
+    \param[in] orientation the EXIF orientation.
+    \return true for orientations 5 to 8.
+ */
+bool ExifReader::isTransposed(int orientation)
+{
+    return orientation >= 5 && orientation <= 8;
+}
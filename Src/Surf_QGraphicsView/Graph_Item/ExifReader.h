@@ -0,0 +1,44 @@
+/*! \file  ExifReader.h
+    \brief Declaration of ExifReader class.
+ */
+
+#ifndef EXIFREADER_H
+#define EXIFREADER_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QString>
+#include <QTransform>
+
+class QIODevice;
+
+/*! \class ExifReader
+    \brief Read the orientation and the embedded thumbnail of a JPEG file from its EXIF APP1 segment.
+
+    Only the segments in front of the APP1 segment are read from the file,
+    the picture itself is neither read nor decoded.
+*/
+class ExifReader
+{
+public:
+    ExifReader(const QString &fileName);  /*!< Constructor, read the EXIF data of a file. */
+    ExifReader(QIODevice *device);  /*!< Constructor, read the EXIF data of a stream. */
+
+    int orientation() const;  /*!< The EXIF orientation, 1 (upright) to 8. */
+    QImage thumbnail() const;  /*!< The embedded thumbnail as stored, null if none. */
+
+    static QTransform orientationTransform(int orientation);  /*!< The transform turning a picture upright. */
+    static bool isTransposed(int orientation);  /*!< Whether the width and height of a picture swap when upright. */
+
+private:
+    void readSegments(QIODevice *device);
+    void parse(const QByteArray &tiff);
+    quint16 readShort(const QByteArray &tiff, int offset) const;
+    quint32 readLong(const QByteArray &tiff, int offset) const;
+
+    bool m_bBigEndian;        /*!< The byte order of the TIFF structure, "MM" or "II". */
+    int m_nOrientation;
+    QByteArray m_thumbnail;   /*!< The JPEG stream of the embedded thumbnail. */
+};
+
+#endif /* EXIFREADER_H */
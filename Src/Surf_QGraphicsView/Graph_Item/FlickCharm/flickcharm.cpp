@@ -229,6 +229,20 @@ static QPoint deaccelerate(const QPoint &speed, int a = 1, int max = 64)
     return QPoint(x, y);
 }
 
+/* Stop the kinetic scrolling of a widget, e.g. before it is scrolled by the program. */
+void FlickCharm::stop(QWidget *widget)
+{
+    QAbstractScrollArea *scrollArea = dynamic_cast<QAbstractScrollArea*>(widget);
+    if (!scrollArea)
+        return;
+
+    FlickData *data = d->flickData.value(scrollArea->viewport());
+    if (data && data->state == FlickData::AutoScroll) {
+        data->state = FlickData::Steady;
+        data->speed = QPoint(0, 0);
+    }
+}
+
 bool FlickCharm::eventFilter(QObject *object, QEvent *event)
 {
     if (!object->isWidgetType())
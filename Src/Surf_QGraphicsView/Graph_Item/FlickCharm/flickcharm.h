@@ -44,6 +44,7 @@ public:
     ~FlickCharm();
     void activateOn(QWidget *widget);
     void deactivateFrom(QWidget *widget);
+    void stop(QWidget *widget);
     bool eventFilter(QObject *object, QEvent *event);
     void (*toScrollItem)(QWidget *widget, const QPoint &p);
 
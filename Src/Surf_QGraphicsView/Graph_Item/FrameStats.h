@@ -0,0 +1,34 @@
+/*! \file  FrameStats.h
+    \brief Declaration of FrameStats class.
+ */
+
+#ifndef FRAMESTATS_H
+#define FRAMESTATS_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QVector>
+
+/*! \class FrameStats
+    \brief The painting times of a run of frames, in nanoseconds, summarized in milliseconds.
+
+    The times are kept, not only summed, so the median and the 95th
+    percentile show the stutter an average hides.
+*/
+class FrameStats
+{
+public:
+    FrameStats();  /*!< Constructor */
+
+    void addFrame(qint64 nsecs);  /*!< Record the painting time of a frame. */
+    void clear();
+    int frames() const;
+    QString summary() const;  /*!< The frames, average, median, 95th percentile and max. */
+
+private:
+    qreal percentile(const QVector<qint64> &sorted, int percent) const;
+
+    QVector<qint64> m_frameTimes;  /*!< The painting time of each frame in nanoseconds. */
+};
+
+#endif /* FRAMESTATS_H */
@@ -0,0 +1,483 @@
+/*! \file  ImageScaler.cpp
+    \brief Implementation of ImageScaler class.
+ */
+
+#include <QVector>
+#include <QList>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <QtGlobal>
+
+#if QT_VERSION < 0x050000
+#include <QtConcurrentMap>
+#else
+#include <QtConcurrent/QtConcurrentMap>
+#endif
+
+/* The kernels below are picked at compile time, x86-64 always has SSE2. */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IMAGE_SCALER_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define IMAGE_SCALER_NEON
+#include <arm_neon.h>
+#endif
+
+#include "ImageScaler.h"
+
+#define MIN_BAND_ROWS 16  /* The fewest destination rows worth a thread. */
+
+/* The weights are fixed point, the ones of a destination pixel sum up to 1 << WEIGHT_BITS.
+   A filtered channel keeps FILTER_BITS of fraction, so it and a weight fit in 16 bits,
+   and a weighted sum of filtered channels in 32 bits. */
+#define WEIGHT_BITS  14
+#define FILTER_BITS   7
+
+/*! \struct Contributions
+    \brief The source pixels covered by each destination pixel along one axis.
+*/
+struct Contributions
+{
+    QVector<int> first;        /*!< The first covered source pixel of each destination pixel. */
+    QVector<int> count;        /*!< The number of covered source pixels. */
+    QVector<int> offset;       /*!< Where the weights of each destination pixel start. */
+    QVector<quint16> weights;  /*!< The covered area of each source pixel, summing up to 1 << WEIGHT_BITS. */
+};
+
+/*! \struct ScaleBand
+    \brief The destination rows scaled by one thread.
+*/
+struct ScaleBand
+{
+    const uchar *srcBits;
+    int srcBytesPerLine;
+    uchar *dstBits;
+    int dstBytesPerLine;
+    int dstWidth;
+    const Contributions *horz;
+    const Contributions *vert;
+    int firstRow, lastRow;  /*!< The destination rows [firstRow, lastRow). */
+};
+
+/*! \fn static void buildContributions(Contributions &contrib, int srcSize, int dstSize)
+    \brief Find the source pixels covered by each destination pixel, srcSize >= dstSize.
+
+    The weights are rounded to fixed point from the covered area so far, so
+    they sum up to exactly 1 and an opaque pixel stays opaque.
+
+    \param[out] contrib the contributions.
+    \param[in] srcSize the number of source pixels.
+    \param[in] dstSize the number of destination pixels.
+    \return NONE.
+ */
+static void buildContributions(Contributions &contrib, int srcSize, int dstSize)
+{
+    const double scale = static_cast<double>(srcSize) / dstSize;
+
+    for (int i = 0; i < dstSize; i++)
+    {
+        /* The destination pixel covers [start, end) of the source. */
+        const double start = i * scale;
+        const double end = qMin(static_cast<double>(srcSize), (i + 1) * scale);
+        const int first = static_cast<int>(start);
+        const int last = qMin(srcSize - 1, static_cast<int>(end - 1e-9));
+
+        contrib.first << first;
+        contrib.count << last - first + 1;
+        contrib.offset << contrib.weights.count();
+
+        /* Each weight is the rounded area covered so far less the one before it. */
+        int previous = 0;
+        for (int j = first; j <= last; j++)
+        {
+            const int covered = (j == last) ? (1 << WEIGHT_BITS)
+                                            : qRound((qMin(end, j + 1.0) - start) / scale * (1 << WEIGHT_BITS));
+            contrib.weights << static_cast<quint16>(covered - previous);
+            previous = covered;
+        }
+    }
+}
+
+#if defined(IMAGE_SCALER_SSE2)
+/*! \fn static void filterRow(const uchar *src, const Contributions &horz, int dstWidth, quint16 *filtered)
+    \brief Filter a source row horizontally, two source pixels per multiply-add with SSE2.
+
+    \param[in] src the source row, 4 bytes per pixel.
+    \param[in] horz the horizontal contributions.
+    \param[in] dstWidth the number of destination pixels.
+    \param[out] filtered 4 channels per destination pixel, with FILTER_BITS of fraction.
+    \return NONE.
+ */
+static void filterRow(const uchar *src, const Contributions &horz, int dstWidth, quint16 *filtered)
+{
+    const quint32 *pixels = reinterpret_cast<const quint32 *>(src);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi32(1 << (WEIGHT_BITS - FILTER_BITS - 1));
+
+    for (int x = 0; x < dstWidth; x++, filtered += 4)
+    {
+        const quint32 *p = pixels + horz.first[x];
+        const quint16 *w = horz.weights.constData() + horz.offset[x];
+        const int count = horz.count[x];
+        __m128i sum = zero;
+        int c = 0;
+
+        /* The channels of two pixels interleaved, times their weights, added pairwise. */
+        for (; c + 1 < count; c += 2)
+        {
+            const __m128i p0 = _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(p[c])), zero);
+            const __m128i p1 = _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(p[c + 1])), zero);
+            const __m128i weights = _mm_set1_epi32(static_cast<int>(w[c] | (static_cast<quint32>(w[c + 1]) << 16)));
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_unpacklo_epi16(p0, p1), weights));
+        }
+
+        if (c < count)
+        {
+            const __m128i p0 = _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(p[c])), zero);
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_unpacklo_epi16(p0, zero), _mm_set1_epi32(w[c])));
+        }
+
+        sum = _mm_srli_epi32(_mm_add_epi32(sum, round), WEIGHT_BITS - FILTER_BITS);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(filtered), _mm_packs_epi32(sum, sum));
+    }
+}
+
+/*! \fn static void accumulateRow(const quint16 *filtered, int weight, quint32 *sum, int n)
+    \brief Add a filtered row times its vertical weight to the sums, eight channels at a time with SSE2.
+
+    \param[in] filtered the filtered row.
+    \param[in] weight the vertical weight of the row.
+    \param[in,out] sum the weighted sums.
+    \param[in] n the number of channels.
+    \return NONE.
+ */
+static void accumulateRow(const quint16 *filtered, int weight, quint32 *sum, int n)
+{
+    const __m128i weights = _mm_set1_epi16(static_cast<short>(weight));
+    int i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m128i f = _mm_loadu_si128(reinterpret_cast<const __m128i *>(filtered + i));
+        const __m128i low = _mm_mullo_epi16(f, weights);
+        const __m128i high = _mm_mulhi_epi16(f, weights);
+        __m128i *s = reinterpret_cast<__m128i *>(sum + i);
+
+        _mm_storeu_si128(s, _mm_add_epi32(_mm_loadu_si128(s), _mm_unpacklo_epi16(low, high)));
+        _mm_storeu_si128(s + 1, _mm_add_epi32(_mm_loadu_si128(s + 1), _mm_unpackhi_epi16(low, high)));
+    }
+
+    for (; i < n; i++)
+        sum[i] += static_cast<quint32>(filtered[i]) * weight;
+}
+
+/*! \fn static void storeRow(const quint32 *sum, uchar *dst, int n)
+    \brief Round the weighted sums to 8-bit channels, four pixels at a time with SSE2.
+
+    \param[in] sum the weighted sums.
+    \param[out] dst the destination row.
+    \param[in] n the number of channels.
+    \return NONE.
+ */
+static void storeRow(const quint32 *sum, uchar *dst, int n)
+{
+    const int shift = WEIGHT_BITS + FILTER_BITS;
+    const __m128i round = _mm_set1_epi32(1 << (shift - 1));
+    int i = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        const __m128i *s = reinterpret_cast<const __m128i *>(sum + i);
+        const __m128i s0 = _mm_srli_epi32(_mm_add_epi32(_mm_loadu_si128(s), round), shift);
+        const __m128i s1 = _mm_srli_epi32(_mm_add_epi32(_mm_loadu_si128(s + 1), round), shift);
+        const __m128i s2 = _mm_srli_epi32(_mm_add_epi32(_mm_loadu_si128(s + 2), round), shift);
+        const __m128i s3 = _mm_srli_epi32(_mm_add_epi32(_mm_loadu_si128(s + 3), round), shift);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                         _mm_packus_epi16(_mm_packs_epi32(s0, s1), _mm_packs_epi32(s2, s3)));
+    }
+
+    for (; i < n; i++)
+        dst[i] = static_cast<uchar>(qMin(255u, (sum[i] + (1u << (shift - 1))) >> shift));
+}
+#elif defined(IMAGE_SCALER_NEON)
+/*! \fn static void filterRow(const uchar *src, const Contributions &horz, int dstWidth, quint16 *filtered)
+    \brief Filter a source row horizontally, the four channels of a pixel per multiply-accumulate with NEON.
+
+    \param[in] src the source row, 4 bytes per pixel.
+    \param[in] horz the horizontal contributions.
+    \param[in] dstWidth the number of destination pixels.
+    \param[out] filtered 4 channels per destination pixel, with FILTER_BITS of fraction.
+    \return NONE.
+ */
+static void filterRow(const uchar *src, const Contributions &horz, int dstWidth, quint16 *filtered)
+{
+    const quint32 *pixels = reinterpret_cast<const quint32 *>(src);
+
+    for (int x = 0; x < dstWidth; x++, filtered += 4)
+    {
+        const quint32 *p = pixels + horz.first[x];
+        const quint16 *w = horz.weights.constData() + horz.offset[x];
+        const int count = horz.count[x];
+        uint32x4_t sum = vdupq_n_u32(0);
+
+        for (int c = 0; c < count; c++)
+        {
+            const uint16x4_t channels = vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(p[c]))));
+            sum = vmlal_n_u16(sum, channels, w[c]);
+        }
+
+        vst1_u16(filtered, vrshrn_n_u32(sum, WEIGHT_BITS - FILTER_BITS));
+    }
+}
+
+/*! \fn static void accumulateRow(const quint16 *filtered, int weight, quint32 *sum, int n)
+    \brief Add a filtered row times its vertical weight to the sums, eight channels at a time with NEON.
+
+    \param[in] filtered the filtered row.
+    \param[in] weight the vertical weight of the row.
+    \param[in,out] sum the weighted sums.
+    \param[in] n the number of channels.
+    \return NONE.
+ */
+static void accumulateRow(const quint16 *filtered, int weight, quint32 *sum, int n)
+{
+    int i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        const uint16x8_t f = vld1q_u16(filtered + i);
+
+        vst1q_u32(sum + i, vmlal_n_u16(vld1q_u32(sum + i), vget_low_u16(f), weight));
+        vst1q_u32(sum + i + 4, vmlal_n_u16(vld1q_u32(sum + i + 4), vget_high_u16(f), weight));
+    }
+
+    for (; i < n; i++)
+        sum[i] += static_cast<quint32>(filtered[i]) * weight;
+}
+
+/*! \fn static void storeRow(const quint32 *sum, uchar *dst, int n)
+    \brief Round the weighted sums to 8-bit channels, two pixels at a time with NEON.
+
+    \param[in] sum the weighted sums.
+    \param[out] dst the destination row.
+    \param[in] n the number of channels.
+    \return NONE.
+ */
+static void storeRow(const quint32 *sum, uchar *dst, int n)
+{
+    const int shift = WEIGHT_BITS + FILTER_BITS;
+    int i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        const uint16x4_t low = vmovn_u32(vrshrq_n_u32(vld1q_u32(sum + i), WEIGHT_BITS + FILTER_BITS));
+        const uint16x4_t high = vmovn_u32(vrshrq_n_u32(vld1q_u32(sum + i + 4), WEIGHT_BITS + FILTER_BITS));
+
+        vst1_u8(dst + i, vqmovn_u16(vcombine_u16(low, high)));
+    }
+
+    for (; i < n; i++)
+        dst[i] = static_cast<uchar>(qMin(255u, (sum[i] + (1u << (shift - 1))) >> shift));
+}
+#else
+/*! \fn static void filterRow(const uchar *src, const Contributions &horz, int dstWidth, quint16 *filtered)
+    \brief Filter a source row horizontally, without SIMD.
+
+    \param[in] src the source row, 4 bytes per pixel.
+    \param[in] horz the horizontal contributions.
+    \param[in] dstWidth the number of destination pixels.
+    \param[out] filtered 4 channels per destination pixel, with FILTER_BITS of fraction.
+    \return NONE.
+ */
+static void filterRow(const uchar *src, const Contributions &horz, int dstWidth, quint16 *filtered)
+{
+    const quint32 round = 1 << (WEIGHT_BITS - FILTER_BITS - 1);
+
+    for (int x = 0; x < dstWidth; x++, filtered += 4)
+    {
+        const uchar *p = src + horz.first[x] * 4;
+        const quint16 *w = horz.weights.constData() + horz.offset[x];
+        quint32 sum[4] = {0, 0, 0, 0};
+
+        for (int c = 0; c < horz.count[x]; c++, p += 4)
+        {
+            sum[0] += w[c] * p[0];
+            sum[1] += w[c] * p[1];
+            sum[2] += w[c] * p[2];
+            sum[3] += w[c] * p[3];
+        }
+
+        for (int i = 0; i < 4; i++)
+            filtered[i] = static_cast<quint16>((sum[i] + round) >> (WEIGHT_BITS - FILTER_BITS));
+    }
+}
+
+/*! \fn static void accumulateRow(const quint16 *filtered, int weight, quint32 *sum, int n)
+    \brief Add a filtered row times its vertical weight to the sums, without SIMD.
+
+    \param[in] filtered the filtered row.
+    \param[in] weight the vertical weight of the row.
+    \param[in,out] sum the weighted sums.
+    \param[in] n the number of channels.
+    \return NONE.
+ */
+static void accumulateRow(const quint16 *filtered, int weight, quint32 *sum, int n)
+{
+    for (int i = 0; i < n; i++)
+        sum[i] += static_cast<quint32>(filtered[i]) * weight;
+}
+
+/*! \fn static void storeRow(const quint32 *sum, uchar *dst, int n)
+    \brief Round the weighted sums to 8-bit channels, without SIMD.
+
+    \param[in] sum the weighted sums.
+    \param[out] dst the destination row.
+    \param[in] n the number of channels.
+    \return NONE.
+ */
+static void storeRow(const quint32 *sum, uchar *dst, int n)
+{
+    const int shift = WEIGHT_BITS + FILTER_BITS;
+
+    for (int i = 0; i < n; i++)
+        dst[i] = static_cast<uchar>(qMin(255u, (sum[i] + (1u << (shift - 1))) >> shift));
+}
+#endif
+
+/*! \fn static void scaleBand(const ScaleBand &band)
+    \brief Scale the destination rows of a band, one filtered source row at a time.
+
+    The channels are worked on in memory order, whichever channel a byte
+    holds, so the kernels do not depend on the byte order of QRgb.
+
+    \param[in] band the band to scale.
+    \return NONE.
+ */
+static void scaleBand(const ScaleBand &band)
+{
+    const int channels = band.dstWidth * 4;
+    QVector<quint16> filtered(channels);  /* A source row filtered horizontally. */
+    QVector<quint32> sum(channels);       /* The weighted sum of the filtered rows. */
+    const Contributions &vert = *band.vert;
+
+    for (int y = band.firstRow; y < band.lastRow; y++)
+    {
+        sum.fill(0);
+
+        for (int r = 0; r < vert.count[y]; r++)
+        {
+            filterRow(band.srcBits + (vert.first[y] + r) * band.srcBytesPerLine, *band.horz, band.dstWidth, filtered.data());
+            accumulateRow(filtered.constData(), vert.weights[vert.offset[y] + r], sum.data(), channels);
+        }
+
+        storeRow(sum.constData(), band.dstBits + y * band.dstBytesPerLine, channels);
+    }
+}
+
+/*! \fn QImage ImageScaler::scaled(const QImage &image, const QSize &size, bool parallel)
+    \brief Downscale a picture by area averaging, using all CPU cores.
+
+    Upscaling, in either direction, is left to Qt::SmoothTransformation.
+
+    \param[in] image the picture.
+    \param[in] size the size to scale to, the aspect ratio is not kept.
+    \param[in] parallel whether to share the rows among the CPU cores or scale on the calling thread.
+    \return the scaled picture, RGB32 or ARGB32_Premultiplied.
+ */
+QImage ImageScaler::scaled(const QImage &image, const QSize &size, bool parallel)
+{
+    if (image.isNull() || size.isEmpty() || size == image.size())
+       return image;
+
+    if (size.width() > image.width() || size.height() > image.height())
+       return image.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+    /* Average premultiplied pixels, so transparent ones do not bleed their color. */
+    const QImage::Format format = image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32;
+    const QImage src = (image.format() == format) ? image : image.convertToFormat(format);
+    QImage dst(size, format);
+
+    Contributions horz, vert;
+    buildContributions(horz, src.width(), size.width());
+    buildContributions(vert, src.height(), size.height());
+
+    /* Split the destination rows into one band per core. */
+    const int nBands = parallel ? qBound(1, size.height() / MIN_BAND_ROWS, qMax(1, QThread::idealThreadCount())) : 1;
+    QList<ScaleBand> bands;
+
+    for (int i = 0; i < nBands; i++)
+    {
+        ScaleBand band;
+        band.srcBits = src.constBits();
+        band.srcBytesPerLine = src.bytesPerLine();
+        band.dstBits = dst.bits();
+        band.dstBytesPerLine = dst.bytesPerLine();
+        band.dstWidth = size.width();
+        band.horz = &horz;
+        band.vert = &vert;
+        band.firstRow = size.height() * i / nBands;
+        band.lastRow = size.height() * (i + 1) / nBands;
+        bands << band;
+    }
+
+    if (nBands == 1)
+       scaleBand(bands.first());
+    else
+       QtConcurrent::blockingMap(bands, scaleBand);
+
+    return dst;
+}
+
+/*! \fn void ImageScaler::benchmark(const QImage &image, const QSize &size, int runs)
+    \brief Print the time of fitting a picture with Qt's scalers and with ImageScaler.
+
+    ImageScaler is timed on one thread, as the slide decoders run it, and
+    on all cores. The kernel it was built with is printed along, so the
+    results of several targets can be told apart.
+
+    \param[in] image the picture.
+    \param[in] size the size to scale to.
+    \param[in] runs the number of runs of each scaler.
+    \return NONE.
+ */
+void ImageScaler::benchmark(const QImage &image, const QSize &size, int runs)
+{
+#if defined(IMAGE_SCALER_SSE2)
+    const char *kernel = "SSE2";
+#elif defined(IMAGE_SCALER_NEON)
+    const char *kernel = "NEON";
+#else
+    const char *kernel = "scalar";
+#endif
+
+    QElapsedTimer timer;
+    qint64 fast = 0, smooth = 0, area = 0, parallel = 0;
+
+    for (int i = 0; i < runs; i++)
+    {
+        timer.start();
+        image.scaled(size, Qt::IgnoreAspectRatio, Qt::FastTransformation);
+        fast += timer.nsecsElapsed();
+
+        timer.start();
+        image.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        smooth += timer.nsecsElapsed();
+
+        timer.start();
+        ImageScaler::scaled(image, size, false);
+        area += timer.nsecsElapsed();
+
+        timer.start();
+        ImageScaler::scaled(image, size);
+        parallel += timer.nsecsElapsed();
+    }
+
+    /* The nanoseconds of all runs to milliseconds per run. */
+    const qreal perRun = 1000000.0 * runs;
+    qDebug("%dx%d -> %dx%d, %d runs : fast %.3f ms, smooth %.3f ms, area average (%s) %.3f ms, on %d threads %.3f ms",
+           image.width(), image.height(), size.width(), size.height(), runs,
+           fast / perRun, smooth / perRun, kernel, area / perRun,
+           QThread::idealThreadCount(), parallel / perRun);
+}
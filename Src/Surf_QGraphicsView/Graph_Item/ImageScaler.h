@@ -0,0 +1,28 @@
+/*! \file  ImageScaler.h
+    \brief Declaration of ImageScaler class.
+ */
+
+#ifndef IMAGESCALER_H
+#define IMAGESCALER_H
+
+#include <QImage>
+#include <QSize>
+
+/*! \class ImageScaler
+    \brief The area-average downscaler fitting the pictures to the window.
+
+    Each destination pixel is the average of the source pixels it covers,
+    weighted by the covered area, so a downscaled picture is free of the
+    aliasing of Qt::FastTransformation. The averages are summed in fixed
+    point, by SSE2 or NEON kernels where the compiler targets them, and the
+    rows are shared among the CPU cores. "-benchscale <image>" times it
+    against Qt::SmoothTransformation on the device.
+*/
+class ImageScaler
+{
+public:
+    static QImage scaled(const QImage &image, const QSize &size, bool parallel = true);  /*!< Downscale a picture. */
+    static void benchmark(const QImage &image, const QSize &size, int runs);  /*!< Compare with Qt's scalers. */
+};
+
+#endif /* IMAGESCALER_H */
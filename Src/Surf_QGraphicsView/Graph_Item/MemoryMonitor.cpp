@@ -0,0 +1,243 @@
+/*! \file  MemoryMonitor.cpp
+    \brief Implementation of MemoryMonitor class.
+ */
+
+#include <QFile>
+#include <QByteArray>
+#include <QList>
+#include <QtGlobal>
+
+#include "MemoryMonitor.h"
+
+#define MEMINFO_FILE       "/proc/meminfo"
+#define CGROUP_FILE        "/proc/self/cgroup"
+#define CGROUP_ROOT        "/sys/fs/cgroup"
+#define MEM_PRESSURE_FILE  "/proc/pressure/memory"
+
+#define PSI_LOW_PERCENT       10.0  /* Some task stalled on memory that share of the last 10 seconds. */
+#define PSI_CRITICAL_PERCENT  10.0  /* All tasks stalled on memory that share of the last 10 seconds. */
+#define RELEASE_MARGIN_PERCENT 150  /* A level is left above that share of its threshold. */
+
+/*! \fn MemoryMonitor::MemoryMonitor(QObject *parent)
+    \brief Constructor, find the cgroup of the process.
+
+    \param[in] parent the parent object.
+ */
+MemoryMonitor::MemoryMonitor(QObject *parent)
+    : QObject(parent)
+    , m_nLowKBytes(DFLT_MEM_LOW_KBYTES)
+    , m_nCriticalKBytes(DFLT_MEM_CRITICAL_KBYTES)
+    , m_pressure(MEM_PRESSURE_NONE)
+    , m_nAvailableKBytes(-1)
+{
+    /* A cgroup v2 line is "0::/path/of/the/group". */
+    QFile file(CGROUP_FILE);
+    if (file.open(QIODevice::ReadOnly))
+    {
+       QByteArray line;
+       while (!(line = file.readLine()).isEmpty())
+       {
+          if (line.startsWith("0::"))
+          {
+             m_cgroupDir = QString(CGROUP_ROOT) + QString::fromLocal8Bit(line.mid(3).trimmed());
+             break;
+          }
+       }
+    }
+
+    QObject::connect(&m_timer, SIGNAL(timeout()), this, SLOT(sample()));
+}
+
+/*! \fn void MemoryMonitor::setThresholds(int lowKBytes, int criticalKBytes)
+    \brief Set the available memory below which each level is reported.
+
+    \param[in] lowKBytes the threshold of MEM_PRESSURE_LOW in kilobytes.
+    \param[in] criticalKBytes the threshold of MEM_PRESSURE_CRITICAL in kilobytes.
+    \return NONE.
+ */
+void MemoryMonitor::setThresholds(int lowKBytes, int criticalKBytes)
+{
+    m_nCriticalKBytes = qMax(0, criticalKBytes);
+    m_nLowKBytes = qMax(m_nCriticalKBytes, lowKBytes);
+}
+
+/*! \fn void MemoryMonitor::start(int interval)
+    \brief Take a sample now and then every interval.
+
+    \param[in] interval the sampling interval in milliseconds, 0 or less does not sample.
+    \return NONE.
+ */
+void MemoryMonitor::start(int interval)
+{
+    if (interval <= 0)
+       return;
+
+    sample();
+    m_timer.start(interval);
+}
+
+/*! \fn void MemoryMonitor::stop()
+    \brief Stop sampling, the last level stays.
+
+    \param[in] NONE.
+    \return NONE.
+ */
+void MemoryMonitor::stop()
+{
+    m_timer.stop();
+}
+
+/*! \fn MemoryPressure MemoryMonitor::pressure() const
+    \brief Return the current level of memory pressure.
+
+    \param[in] NONE.
+    \return the level.
+ */
+MemoryPressure MemoryMonitor::pressure() const
+{
+    return m_pressure;
+}
+
+/*! \fn qint64 MemoryMonitor::availableKBytes() const
+    \brief Return the memory available to the process at the last sample.
+
+    \param[in] NONE.
+    \return the available memory in kilobytes, -1 if unknown.
+ */
+qint64 MemoryMonitor::availableKBytes() const
+{
+    return m_nAvailableKBytes;
+}
+
+/*! \fn void MemoryMonitor::sample()
+    \brief Read the available memory and the stall averages, and report a change of level.
+
+    \param[in] NONE.
+    \return NONE.
+ */
+void MemoryMonitor::sample()
+{
+    qint64 available = readMemAvailable();
+    qint64 headroom = readCgroupHeadroom();
+
+    if (headroom >= 0 && (available < 0 || headroom < available))
+       available = headroom;
+
+    m_nAvailableKBytes = available;
+
+    /* The level the memory alone calls for ... */
+    MemoryPressure level = MEM_PRESSURE_NONE;
+    if (available >= 0 && available < m_nCriticalKBytes)
+       level = MEM_PRESSURE_CRITICAL;
+    else if (available >= 0 && available < m_nLowKBytes)
+       level = MEM_PRESSURE_LOW;
+
+    /* ... raised by the reclaim stalls. */
+    if (readStallAverage("full") >= PSI_CRITICAL_PERCENT)
+       level = MEM_PRESSURE_CRITICAL;
+    else if (level == MEM_PRESSURE_NONE && readStallAverage("some") >= PSI_LOW_PERCENT)
+       level = MEM_PRESSURE_LOW;
+
+    /* Going down a level needs room to spare, going up does not wait. */
+    if (level < m_pressure)
+    {
+       qint64 threshold = (m_pressure == MEM_PRESSURE_CRITICAL) ? m_nCriticalKBytes : m_nLowKBytes;
+       if (available >= 0 && available * 100 < threshold * RELEASE_MARGIN_PERCENT)
+          return;
+    }
+
+    if (level != m_pressure)
+    {
+       m_pressure = level;
+       emit pressureChanged(m_pressure);
+    }
+}
+
+/*! \fn qint64 MemoryMonitor::readMemAvailable() const
+    \brief Read the memory the system can give without swapping.
+
+    \param[in] NONE.
+    \return MemAvailable in kilobytes, -1 if unknown.
+ */
+qint64 MemoryMonitor::readMemAvailable() const
+{
+    QFile file(MEMINFO_FILE);
+    if (!file.open(QIODevice::ReadOnly))
+       return -1;
+
+    /* The line is "MemAvailable:   123456 kB". */
+    QByteArray line;
+    while (!(line = file.readLine()).isEmpty())
+    {
+       if (line.startsWith("MemAvailable:"))
+       {
+          QList<QByteArray> fields = line.simplified().split(' ');
+          bool ok = false;
+          qint64 kbytes = (fields.count() >= 2) ? fields[1].toLongLong(&ok) : -1;
+
+          return ok ? kbytes : -1;
+       }
+    }
+
+    return -1;
+}
+
+/*! \fn qint64 MemoryMonitor::readCgroupHeadroom() const
+    \brief Read how much the cgroup of the process can still be charged before its limit.
+
+    \param[in] NONE.
+    \return the headroom in kilobytes, -1 without a cgroup limit.
+ */
+qint64 MemoryMonitor::readCgroupHeadroom() const
+{
+    if (m_cgroupDir.isEmpty())
+       return -1;
+
+    QFile maxFile(m_cgroupDir + "/memory.max");
+    QFile currentFile(m_cgroupDir + "/memory.current");
+    if (!maxFile.open(QIODevice::ReadOnly) || !currentFile.open(QIODevice::ReadOnly))
+       return -1;
+
+    /* memory.max is "max" without a limit, the values are in bytes. */
+    bool limited = false, ok = false;
+    qint64 limit = maxFile.readLine().trimmed().toLongLong(&limited);
+    qint64 current = currentFile.readLine().trimmed().toLongLong(&ok);
+    if (!limited || !ok)
+       return -1;
+
+    return qMax((qint64)0, limit - current) / 1024;
+}
+
+/*! \fn double MemoryMonitor::readStallAverage(const char *kind) const
+    \brief Read the share of the last 10 seconds tasks stalled on memory.
+
+    \param[in] kind "some" for any task, "full" for all tasks at once.
+    \return the avg10 percentage, -1 if unknown.
+ */
+double MemoryMonitor::readStallAverage(const char *kind) const
+{
+    QFile file(MEM_PRESSURE_FILE);
+    if (!file.open(QIODevice::ReadOnly))
+       return -1;
+
+    /* The lines are "some avg10=0.00 avg60=0.00 avg300=0.00 total=0". */
+    QByteArray line;
+    while (!(line = file.readLine()).isEmpty())
+    {
+       if (!line.startsWith(kind))
+          continue;
+
+       foreach (const QByteArray &field, line.simplified().split(' '))
+       {
+          if (field.startsWith("avg10="))
+          {
+             bool ok = false;
+             double percent = field.mid(6).toDouble(&ok);
+
+             return ok ? percent : -1;
+          }
+       }
+    }
+
+    return -1;
+}
@@ -0,0 +1,69 @@
+/*! \file  MemoryMonitor.h
+    \brief Declaration of MemoryMonitor class.
+ */
+
+#ifndef MEMORYMONITOR_H
+#define MEMORYMONITOR_H
+
+#include <QObject>
+#include <QTimer>
+#include <QString>
+
+#define DFLT_MEM_LOW_KBYTES       131072  /* The available memory below which the caches shrink. */
+#define DFLT_MEM_CRITICAL_KBYTES   49152  /* The available memory below which the caches are dropped. */
+#define DFLT_MEM_POLL_INTERVAL      2000  /* The default sampling interval in milliseconds. */
+
+/*! \enum MemoryPressure
+    \brief The levels of memory pressure, in the order the caches are shed.
+*/
+enum MemoryPressure{
+    MEM_PRESSURE_NONE = 0,  /*!< Enough memory, the caches use their configured budgets. */
+    MEM_PRESSURE_LOW,       /*!< Little memory left, the caches shrink. */
+    MEM_PRESSURE_CRITICAL   /*!< Close to the OOM killer, only the slides on screen are kept. */
+};
+
+/*! \class MemoryMonitor
+    \brief Sample the memory available to the process and report the pressure level.
+
+    The available memory is MemAvailable of /proc/meminfo, or the headroom
+    below the memory.max of the process's cgroup v2 when that is smaller.
+    The stall averages of /proc/pressure/memory raise the level as well, as
+    the kernel reports reclaim stalls before the free memory runs out.
+    A level is left only when the memory is back well above its threshold,
+    so the caches do not grow and shrink on every sample. Without these
+    files, e.g. not on Linux, the level stays MEM_PRESSURE_NONE.
+*/
+class MemoryMonitor : public QObject
+{
+Q_OBJECT
+
+public:
+    MemoryMonitor(QObject *parent = 0);  /*!< Constructor */
+
+    void setThresholds(int lowKBytes, int criticalKBytes);
+    void start(int interval = DFLT_MEM_POLL_INTERVAL);  /*!< Sample every interval milliseconds. */
+    void stop();
+
+    MemoryPressure pressure() const;
+    qint64 availableKBytes() const;  /*!< The last sample, -1 if unknown. */
+
+signals:
+    void pressureChanged(int pressure);  /*!< A MemoryPressure value. */
+
+private slots:
+    void sample();
+
+private:
+    qint64 readMemAvailable() const;
+    qint64 readCgroupHeadroom() const;
+    double readStallAverage(const char *kind) const;  /*!< The avg10 of the "some" or "full" line. */
+
+    QTimer m_timer;
+    QString m_cgroupDir;       /*!< The cgroup v2 folder of the process, empty if none. */
+    int m_nLowKBytes;
+    int m_nCriticalKBytes;
+    MemoryPressure m_pressure;
+    qint64 m_nAvailableKBytes;
+};
+
+#endif /* MEMORYMONITOR_H */
@@ -0,0 +1,370 @@
+/*! \file  ScrubberBar.cpp
+    \brief Implementation of ScrubberBar class.
+ */
+
+#include <QtGlobal>
+
+#if QT_VERSION >= 0x050000
+#include <QtWidgets/QApplication>
+#else
+#include <QApplication>
+#endif
+
+#include <QPainter>
+#include <QMouseEvent>
+#include <QPaintEvent>
+#include <QResizeEvent>
+#include <QMultiMap>
+#include <qmath.h>
+
+#include "ScrubberBar.h"
+
+#define THUMB_WIDTH     64  /* The box the thumbnails fit in. */
+#define THUMB_HEIGHT    40
+#define THUMB_GAP        4  /* The space between two thumbnails. */
+#define THUMB_PITCH     (THUMB_WIDTH + THUMB_GAP)
+#define ATLAS_COLUMNS   16  /* 16 x 32 cells, 512 thumbnails in 5 MB. */
+#define ATLAS_ROWS      32
+
+#define SCRUB_ACCEL_PIXELS  8  /* A drag faster than that per event moves the strip a multiple of it. */
+
+/*! \fn ScrubberBar::ScrubberBar(QWidget *parent)
+    \brief Constructor
+
+    \param[in] parent the parent widget, the viewport of the view.
+ */
+ScrubberBar::ScrubberBar(QWidget *parent)
+    : QWidget(parent)
+    , m_atlas(QSize(THUMB_WIDTH, THUMB_HEIGHT), ATLAS_COLUMNS, ATLAS_ROWS)
+    , m_loader(QSize(THUMB_WIDTH, THUMB_HEIGHT))
+    , m_nCount(0)
+    , m_nCurrent(0)
+    , m_nScroll(0)
+    , m_bDragging(false)
+    , m_bMoved(false)
+    , m_nPressX(0)
+    , m_nLastX(0)
+{
+    QObject::connect(&m_loader, SIGNAL(thumbnailLoaded(int, QImage)), this, SLOT(thumbnailLoaded(int, QImage)));
+}
+
+/*! \fn void ScrubberBar::setFiles(const QStringList &files)
+    \brief Browse picture files, the thumbnails of other slides are dropped.
+
+    \param[in] files the picture file of each slide.
+    \return NONE.
+ */
+void ScrubberBar::setFiles(const QStringList &files)
+{
+    if (files == m_files && m_bundleFile.isEmpty() && m_nCount == files.count())
+       return;
+
+    m_files = files;
+    m_bundleFile.clear();
+    m_nCount = files.count();
+    m_atlas.clear();
+    m_lastRequest.clear();
+    m_loader.setFiles(files);
+
+    m_nCurrent = qBound(0, m_nCurrent, qMax(0, m_nCount - 1));
+    centerOn(m_nCurrent);
+    update();
+}
+
+/*! \fn void ScrubberBar::setBundle(const QString &fileName, int count)
+    \brief Browse the slides of a bundle, the thumbnails of other slides are dropped.
+
+    \param[in] fileName the slide bundle.
+    \param[in] count the number of slides in the bundle.
+    \return NONE.
+ */
+void ScrubberBar::setBundle(const QString &fileName, int count)
+{
+    if (fileName == m_bundleFile && m_nCount == count)
+       return;
+
+    m_files.clear();
+    m_bundleFile = fileName;
+    m_nCount = count;
+    m_atlas.clear();
+    m_lastRequest.clear();
+    m_loader.setBundle(fileName);
+
+    m_nCurrent = qBound(0, m_nCurrent, qMax(0, m_nCount - 1));
+    centerOn(m_nCurrent);
+    update();
+}
+
+/*! \fn void ScrubberBar::setCurrent(int index)
+    \brief Center the strip on a slide, e.g. when the view moved, unless the strip is being dragged.
+
+    \param[in] index the index of the slide.
+    \return NONE.
+ */
+void ScrubberBar::setCurrent(int index)
+{
+    if (m_bDragging || index == m_nCurrent)
+       return;
+
+    m_nCurrent = index;
+    centerOn(index);
+    update();
+}
+
+/*! \fn int ScrubberBar::current() const
+    \brief Return the slide under the marker.
+
+    \param[in] NONE.
+    \return the index of the slide.
+ */
+int ScrubberBar::current() const
+{
+    return m_nCurrent;
+}
+
+/*! \fn QSize ScrubberBar::thumbnailSize() const
+    \brief Return the box a thumbnail is scaled into, keeping its aspect ratio.
+
+    \param[in] NONE.
+    \return the cell size of the atlas.
+ */
+QSize ScrubberBar::thumbnailSize() const
+{
+    return m_atlas.cellSize();
+}
+
+/*! \fn bool ScrubberBar::hasThumbnail(int index) const
+    \brief Check if the thumbnail of a slide is in the atlas.
+
+    \param[in] index the index of the slide.
+    \return true if it is there.
+ */
+bool ScrubberBar::hasThumbnail(int index) const
+{
+    return m_atlas.contains(index);
+}
+
+/*! \fn void ScrubberBar::addThumbnail(int index, const QImage &thumbnail)
+    \brief Take the thumbnail of a slide scaled from its decoded picture by the slide loader, no file is read.
+
+    \param[in] index the index of the slide.
+    \param[in] thumbnail the thumbnail, within thumbnailSize().
+    \return NONE.
+ */
+void ScrubberBar::addThumbnail(int index, const QImage &thumbnail)
+{
+    if (thumbnail.isNull() || index < 0 || index >= m_nCount || m_atlas.contains(index))
+       return;
+
+    m_atlas.insert(index, thumbnail);
+    m_lastRequest.removeAll(index);
+    update();
+}
+
+/*! \fn QImage ScrubberBar::thumbnail(int index)
+    \brief Return a copy of the thumbnail of a slide, e.g. to stand in for the slide while scrubbing.
+
+    \param[in] index the index of the slide.
+    \return the thumbnail, null if it is not in the atlas.
+ */
+QImage ScrubberBar::thumbnail(int index)
+{
+    QRect source = m_atlas.find(index);
+
+    return source.isNull() ? QImage() : m_atlas.image().copy(source);
+}
+
+/*! \fn void ScrubberBar::thumbnailLoaded(int index, const QImage &thumbnail)
+    \brief Put a thumbnail made by the loader into the atlas.
+
+    \param[in] index the index of the slide.
+    \param[in] thumbnail the thumbnail, null if the picture could not be read.
+    \return NONE.
+ */
+void ScrubberBar::thumbnailLoaded(int index, const QImage &thumbnail)
+{
+    if (thumbnail.isNull())
+    {
+       /* A blank thumbnail, so the picture is not read again on every paint. */
+       QImage blank(m_atlas.cellSize(), QImage::Format_RGB32);
+       blank.fill(qRgb(64, 64, 64));
+       m_atlas.insert(index, blank);
+    }
+    else
+       m_atlas.insert(index, thumbnail);
+
+    m_lastRequest.removeAll(index);
+    update();
+}
+
+/*! \fn int ScrubberBar::indexAt(int x) const
+    \brief Return the slide under a position of the bar.
+
+    \param[in] x the x-axis position in the bar.
+    \return the index of the slide, bounded to the slides.
+ */
+int ScrubberBar::indexAt(int x) const
+{
+    return qBound(0, qFloor(static_cast<qreal>(x + m_nScroll) / THUMB_PITCH), qMax(0, m_nCount - 1));
+}
+
+/*! \fn void ScrubberBar::centerOn(int index)
+    \brief Scroll the strip to put a slide under the marker.
+
+    \param[in] index the index of the slide.
+    \return NONE.
+ */
+void ScrubberBar::centerOn(int index)
+{
+    m_nScroll = index * THUMB_PITCH + THUMB_PITCH / 2 - width() / 2;
+}
+
+/*! \fn void ScrubberBar::paintEvent(QPaintEvent *event)
+    \brief Draw the thumbnails under the bar from the atlas, and request the missing ones.
+
+    \param[in] QPaintEvent object.
+    \return NONE.
+ */
+void ScrubberBar::paintEvent(QPaintEvent *event)
+{
+    /* Translucent over the slides. */
+    QPainter painter(this);
+    painter.fillRect(event->rect(), QColor(0, 0, 0, 160));
+
+    if (m_nCount <= 0)
+       return;
+
+    /* The request covers the whole bar, not only the exposed part, or a partial repaint would drop thumbnails. */
+    int first = indexAt(rect().left());
+    int last = indexAt(rect().right());
+    QMultiMap<int, int> missing;  /* By the distance to the marker. */
+
+    for (int i = first; i <= last; i++)
+    {
+       QRect cell(i * THUMB_PITCH - m_nScroll + THUMB_GAP / 2, (height() - THUMB_HEIGHT) / 2, THUMB_WIDTH, THUMB_HEIGHT);
+       QRect source = m_atlas.find(i);
+
+       if (source.isNull())
+          missing.insert(qAbs(i - m_nCurrent), i);
+
+       if (!cell.intersects(event->rect()))
+          continue;
+
+       if (source.isNull())
+       {
+          painter.fillRect(cell, QColor(64, 64, 64));
+          continue;
+       }
+
+       QRect target(QPoint(0, 0), source.size());
+       target.moveCenter(cell.center());
+       painter.drawImage(target.topLeft(), m_atlas.image(), source);
+    }
+
+    /* The marker around the current slide. */
+    painter.setPen(QPen(Qt::white, 2));
+    painter.setBrush(Qt::NoBrush);
+    painter.drawRect(m_nCurrent * THUMB_PITCH - m_nScroll, 1, THUMB_PITCH, height() - 2);
+
+    /* Only the thumbnails under the bar are made, the nearest to the marker first. */
+    QList<int> request = missing.values();
+    if (request != m_lastRequest)
+    {
+       m_loader.request(request);
+       m_lastRequest = request;
+    }
+}
+
+/*! \fn void ScrubberBar::resizeEvent(QResizeEvent *event)
+    \brief Keep the current slide under the marker.
+
+    \param[in] QResizeEvent object.
+    \return NONE.
+ */
+void ScrubberBar::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    centerOn(m_nCurrent);
+}
+
+/*! \fn void ScrubberBar::mousePressEvent(QMouseEvent *event)
+    \brief Start a drag or a click on the strip.
+
+    \param[in] QMouseEvent object.
+    \return NONE.
+ */
+void ScrubberBar::mousePressEvent(QMouseEvent *event)
+{
+    m_bDragging = true;
+    m_bMoved = false;
+    m_nPressX = m_nLastX = event->x();
+}
+
+/*! \fn void ScrubberBar::mouseMoveEvent(QMouseEvent *event)
+    \brief Drag the strip, the slide coming under the marker becomes the current one.
+
+    \param[in] QMouseEvent object.
+    \return NONE.
+ */
+void ScrubberBar::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!m_bDragging || m_nCount <= 0)
+       return;
+
+    int dx = event->x() - m_nLastX;
+    m_nLastX = event->x();
+
+    /* A drag crosses slides faster than full decodes are made, they wait for the release. */
+    if (!m_bMoved && qAbs(event->x() - m_nPressX) >= QApplication::startDragDistance())
+    {
+       m_bMoved = true;
+       m_loader.setDeferFullDecode(true);
+    }
+
+    if (!m_bMoved)
+       return;
+
+    /* The strip follows the pointer, and runs ahead of a fast drag to cross thousands of slides. */
+    m_nScroll -= dx * qMax(1, qAbs(dx) / SCRUB_ACCEL_PIXELS);
+    m_nScroll = qBound(THUMB_PITCH / 2 - width() / 2, m_nScroll, (m_nCount - 1) * THUMB_PITCH + THUMB_PITCH / 2 - width() / 2);
+
+    int index = indexAt(width() / 2);
+    if (index != m_nCurrent)
+    {
+       m_nCurrent = index;
+       emit slideScrubbed(index);
+    }
+
+    update();
+}
+
+/*! \fn void ScrubberBar::mouseReleaseEvent(QMouseEvent *event)
+    \brief Finish a drag, or pick the clicked slide.
+
+    \param[in] QMouseEvent object.
+    \return NONE.
+ */
+void ScrubberBar::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (!m_bDragging)
+       return;
+
+    m_bDragging = false;
+    if (m_bMoved)
+    {
+       /* Request the thumbnails skipped during the drag again. */
+       m_loader.setDeferFullDecode(false);
+       m_lastRequest.clear();
+    }
+
+    if (m_nCount <= 0)
+       return;
+
+    if (!m_bMoved)
+       m_nCurrent = indexAt(event->x());
+
+    centerOn(m_nCurrent);
+    update();
+
+    emit scrubFinished(m_nCurrent);
+}
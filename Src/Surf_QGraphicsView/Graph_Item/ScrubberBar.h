@@ -0,0 +1,83 @@
+/*! \file  ScrubberBar.h
+    \brief Declaration of ScrubberBar class.
+ */
+
+#ifndef SCRUBBERBAR_H
+#define SCRUBBERBAR_H
+
+#include <QtGlobal>
+
+#if QT_VERSION >= 0x050000
+#include <QtWidgets/QWidget>
+#else
+#include <QWidget>
+#endif
+
+#include <QImage>
+#include <QList>
+#include <QStringList>
+
+#include "ThumbnailAtlas.h"
+#include "ThumbnailLoader.h"
+
+#define SCRUBBER_HEIGHT  52  /* The height of the scrubber bar over the bottom of the view. */
+
+/*! \class ScrubberBar
+    \brief The strip of slide thumbnails over the bottom of the view, dragged to browse the slides.
+
+    The slide under the marker in the middle of the strip is the current one.
+    Only the thumbnails under the strip are drawn, all from one atlas, and
+    the slide under a point is a division of its position, so the strip
+    costs the same for ten slides or ten thousand.
+*/
+class ScrubberBar : public QWidget
+{
+Q_OBJECT
+
+public:
+    ScrubberBar(QWidget *parent = 0);  /*!< Constructor */
+
+    void setFiles(const QStringList &files);  /*!< Browse picture files. */
+    void setBundle(const QString &fileName, int count);  /*!< Browse the slides of a bundle. */
+    void setCurrent(int index);  /*!< Center the strip on a slide, unless it is being dragged. */
+    int current() const;
+
+    QSize thumbnailSize() const;  /*!< The largest size of a thumbnail. */
+    bool hasThumbnail(int index) const;
+    void addThumbnail(int index, const QImage &thumbnail);  /*!< Take a thumbnail scaled from a decoded slide. */
+    QImage thumbnail(int index);  /*!< The thumbnail of a slide, null if not made yet. */
+
+signals:
+    void slideScrubbed(int index);  /*!< The current slide changed while dragging. */
+    void scrubFinished(int index);  /*!< The strip was released, or a thumbnail clicked. */
+
+protected:
+    void paintEvent(QPaintEvent *event);
+    void resizeEvent(QResizeEvent *event);
+    void mousePressEvent(QMouseEvent *event);
+    void mouseMoveEvent(QMouseEvent *event);
+    void mouseReleaseEvent(QMouseEvent *event);
+
+private slots:
+    void thumbnailLoaded(int index, const QImage &thumbnail);
+
+private:
+    int indexAt(int x) const;  /*!< The slide under a position of the strip. */
+    void centerOn(int index);
+
+    ThumbnailAtlas m_atlas;
+    ThumbnailLoader m_loader;
+    QStringList m_files;
+    QString m_bundleFile;
+    QList<int> m_lastRequest;  /*!< The thumbnails last requested to the loader. */
+
+    int m_nCount;      /*!< The number of slides. */
+    int m_nCurrent;    /*!< The slide under the marker. */
+    int m_nScroll;     /*!< The position of the strip at the left edge of the bar. */
+    bool m_bDragging;
+    bool m_bMoved;     /*!< The press became a drag. */
+    int m_nPressX;
+    int m_nLastX;
+};
+
+#endif /* SCRUBBERBAR_H */
@@ -0,0 +1,54 @@
+/*! \file  SlideBenchmark.h
+    \brief Declaration of SlideBenchmark class.
+ */
+
+#ifndef SLIDEBENCHMARK_H
+#define SLIDEBENCHMARK_H
+
+#include <QObject>
+#include <QList>
+#include <QPoint>
+#include <QString>
+
+class SlidingWindow;
+
+/*! \struct BenchmarkConfig
+    \brief A rendering profile and a set of features to run the slide benchmark with.
+*/
+struct BenchmarkConfig
+{
+    int profile;   /*!< A RenderProfile, -1 for the one of the layout file. */
+    int options;   /*!< OR-ed SlidingWindowOption values. */
+    QString name;  /*!< The configuration as given on the command line, empty for the configured one. */
+};
+
+/*! \class SlideBenchmark
+    \brief Runs the slide benchmark once per configuration in one process.
+
+    Each configuration gets a new window, created once the window of the
+    previous one has reported, so the features which are only set up with
+    a window can be compared too. The application quits after the last one.
+*/
+class SlideBenchmark : public QObject
+{
+Q_OBJECT
+
+public:
+    SlideBenchmark(const QList<BenchmarkConfig> &configs, int sweeps, const QPoint &pos, QObject *parent = 0);  /*!< Constructor */
+
+    void start();  /*!< Open the window of the first configuration. */
+
+private slots:
+    void windowFinished(const QString &summary);  /*!< Report a configuration and run the next one. */
+
+private:
+    void runNext();
+
+    QList<BenchmarkConfig> m_configs;
+    int m_nSweeps;            /*!< The sweeps of each configuration. */
+    QPoint m_pos;             /*!< The position of the windows. */
+    int m_nCurrent;           /*!< The configuration running, -1 before start(). */
+    SlidingWindow *m_window;  /*!< The window of the running configuration. */
+};
+
+#endif /* SLIDEBENCHMARK_H */
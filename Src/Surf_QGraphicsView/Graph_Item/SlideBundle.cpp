@@ -0,0 +1,273 @@
+/*! \file  SlideBundle.cpp
+    \brief Implementation of SlideBundle and SlideBundleWriter classes.
+ */
+
+#include <QtGlobal>
+#include <string.h>
+
+#include "SlideBundle.h"
+
+/*! \fn static quint64 alignUp(quint64 value, quint64 alignment)
+    \brief Round a value up to a multiple of a power of two.
+
+    \param[in] value the value.
+    \param[in] alignment the power of two.
+    \return the rounded value.
+ */
+static quint64 alignUp(quint64 value, quint64 alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+/*! \fn SlideBundle::SlideBundle()
+    \brief Constructor
+ */
+SlideBundle::SlideBundle()
+    : m_data(NULL)
+    , m_header(NULL)
+    , m_entries(NULL)
+{
+}
+
+/*! \fn SlideBundle::~SlideBundle()
+    \brief Destructor
+ */
+SlideBundle::~SlideBundle()
+{
+    close();
+}
+
+/*! \fn bool SlideBundle::open(const QString &fileName)
+    \brief Map a slide bundle and check its header and offset table.
+
+    \param[in] fileName the slide bundle.
+    \return true if the bundle is mapped and valid.
+ */
+bool SlideBundle::open(const QString &fileName)
+{
+    close();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly) || m_file.size() < (qint64)sizeof(SlideBundleHeader))
+    {
+       qDebug("%s - %s(%d) : Cannot open the slide bundle!!!", __FILE__, __FUNCTION__, __LINE__);
+       close();
+       return false;
+    }
+
+    /* The slides are read where they are mapped, the kernel pages them in when shown. */
+    m_data = m_file.map(0, m_file.size());
+    if (m_data == NULL)
+    {
+       qDebug("%s - %s(%d) : Cannot map the slide bundle!!!", __FILE__, __FUNCTION__, __LINE__);
+       close();
+       return false;
+    }
+
+    const quint64 fileSize = m_file.size();
+    const SlideBundleHeader *header = reinterpret_cast<const SlideBundleHeader *>(m_data);
+
+    if (memcmp(header->magic, SLIDE_BUNDLE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != SLIDE_BUNDLE_VERSION || header->byteOrder != SLIDE_BUNDLE_BYTE_ORDER ||
+        sizeof(SlideBundleHeader) + (quint64)header->count * sizeof(SlideBundleEntry) > fileSize)
+    {
+       qDebug("%s - %s(%d) : Not a slide bundle of this machine!!!", __FILE__, __FUNCTION__, __LINE__);
+       close();
+       return false;
+    }
+
+    const SlideBundleEntry *entries = reinterpret_cast<const SlideBundleEntry *>(m_data + sizeof(SlideBundleHeader));
+
+    for (quint32 i = 0; i < header->count; i++)
+    {
+       const SlideBundleEntry &entry = entries[i];
+
+       if (entry.offset % SLIDE_BUNDLE_ROW_ALIGN != 0 || entry.bytesPerLine < entry.width * 4 ||
+           entry.offset + (quint64)entry.bytesPerLine * entry.height > fileSize)
+       {
+          qDebug("%s - %s(%d) : Slide %u is out of the slide bundle!!!", __FILE__, __FUNCTION__, __LINE__, i);
+          close();
+          return false;
+       }
+    }
+
+    m_header = header;
+    m_entries = entries;
+
+    return true;
+}
+
+/*! \fn void SlideBundle::close()
+    \brief Unmap the slide bundle, the images on it must not be used any more.
+
+    \param[in] NONE.
+    \return NONE.
+ */
+void SlideBundle::close()
+{
+    if (m_data != NULL)
+       m_file.unmap(m_data);
+
+    m_file.close();
+    m_data = NULL;
+    m_header = NULL;
+    m_entries = NULL;
+}
+
+/*! \fn bool SlideBundle::isOpen() const
+    \brief Check if a valid slide bundle is mapped.
+
+    \param[in] NONE.
+    \return true if a bundle is mapped.
+ */
+bool SlideBundle::isOpen() const
+{
+    return m_header != NULL;
+}
+
+/*! \fn int SlideBundle::count() const
+    \brief Return the number of slides.
+
+    \param[in] NONE.
+    \return the number of slides, 0 when closed.
+ */
+int SlideBundle::count() const
+{
+    return isOpen() ? static_cast<int>(m_header->count) : 0;
+}
+
+/*! \fn QSize SlideBundle::targetSize() const
+    \brief Return the window size the slides are scaled for.
+
+    \param[in] NONE.
+    \return the window size.
+ */
+QSize SlideBundle::targetSize() const
+{
+    return isOpen() ? QSize(m_header->width, m_header->height) : QSize();
+}
+
+/*! \fn QSize SlideBundle::slideSize(int index) const
+    \brief Return the size of a slide.
+
+    \param[in] index the index of the slide.
+    \return the size.
+ */
+QSize SlideBundle::slideSize(int index) const
+{
+    if (index < 0 || index >= count())
+       return QSize();
+
+    return QSize(m_entries[index].width, m_entries[index].height);
+}
+
+/*! \fn QImage SlideBundle::slide(int index) const
+    \brief Return a slide as a read-only image on the mapping, valid until the bundle is closed.
+
+    \param[in] index the index of the slide.
+    \return the slide, premultiplied ARGB32.
+ */
+QImage SlideBundle::slide(int index) const
+{
+    if (index < 0 || index >= count())
+       return QImage();
+
+    const SlideBundleEntry &entry = m_entries[index];
+
+    return QImage(static_cast<const uchar *>(m_data + entry.offset), entry.width, entry.height,
+                  entry.bytesPerLine, QImage::Format_ARGB32_Premultiplied);
+}
+
+/*! \fn SlideBundleWriter::SlideBundleWriter(const QString &fileName, const QSize &targetSize, int count)
+    \brief Constructor, create the file and leave room for the header and offset table.
+
+    \param[in] fileName the slide bundle to write.
+    \param[in] targetSize the window size the slides are scaled for.
+    \param[in] count the number of slides to add.
+ */
+SlideBundleWriter::SlideBundleWriter(const QString &fileName, const QSize &targetSize, int count)
+    : m_file(fileName)
+    , m_entries(count)
+    , m_nAdded(0)
+    , m_bFailed(false)
+{
+    memset(&m_header, 0, sizeof(m_header));
+    memcpy(m_header.magic, SLIDE_BUNDLE_MAGIC, sizeof(m_header.magic));
+    m_header.version = SLIDE_BUNDLE_VERSION;
+    m_header.byteOrder = SLIDE_BUNDLE_BYTE_ORDER;
+    m_header.count = count;
+    m_header.width = targetSize.width();
+    m_header.height = targetSize.height();
+
+    m_bFailed = !m_file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+}
+
+/*! \fn bool SlideBundleWriter::addSlide(const QImage &image)
+    \brief Append a slide in its own aligned pixel block.
+
+    \param[in] image the slide, already scaled and upright.
+    \return false on a write error or when all slides were added.
+ */
+bool SlideBundleWriter::addSlide(const QImage &image)
+{
+    if (m_bFailed || m_nAdded >= m_entries.count())
+       return false;
+
+    const QImage slide = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    SlideBundleEntry &entry = m_entries[m_nAdded];
+
+    /* The first block follows the offset table, the others the previous block. */
+    quint64 end = (m_nAdded == 0) ? sizeof(SlideBundleHeader) + m_entries.count() * sizeof(SlideBundleEntry)
+                                  : m_entries[m_nAdded - 1].offset + (quint64)m_entries[m_nAdded - 1].bytesPerLine * m_entries[m_nAdded - 1].height;
+
+    memset(&entry, 0, sizeof(entry));
+    entry.offset = alignUp(end, SLIDE_BUNDLE_BLOCK_ALIGN);
+    entry.width = slide.width();
+    entry.height = slide.height();
+    entry.bytesPerLine = alignUp(slide.width() * 4, SLIDE_BUNDLE_ROW_ALIGN);
+
+    if (!m_file.seek(entry.offset))
+    {
+       m_bFailed = true;
+       return false;
+    }
+
+    QByteArray row(entry.bytesPerLine, 0);
+    for (int y = 0; y < slide.height(); y++)
+    {
+       memcpy(row.data(), slide.constScanLine(y), slide.width() * 4);
+
+       if (m_file.write(row) != row.size())
+       {
+          m_bFailed = true;
+          return false;
+       }
+    }
+
+    m_nAdded++;
+
+    return true;
+}
+
+/*! \fn bool SlideBundleWriter::finish()
+    \brief Write the header and offset table in front of the pixel blocks.
+
+    \param[in] NONE.
+    \return true if the bundle is complete.
+ */
+bool SlideBundleWriter::finish()
+{
+    if (m_bFailed || m_nAdded != m_entries.count() || !m_file.seek(0))
+       return false;
+
+    if (m_file.write(reinterpret_cast<const char *>(&m_header), sizeof(m_header)) != sizeof(m_header))
+       return false;
+
+    qint64 tableSize = m_entries.count() * sizeof(SlideBundleEntry);
+    if (m_file.write(reinterpret_cast<const char *>(m_entries.constData()), tableSize) != tableSize)
+       return false;
+
+    m_file.close();
+
+    return true;
+}
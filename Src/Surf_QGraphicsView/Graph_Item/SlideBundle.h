@@ -0,0 +1,98 @@
+/*! \file  SlideBundle.h
+    \brief Declaration of SlideBundle and SlideBundleWriter classes.
+ */
+
+#ifndef SLIDEBUNDLE_H
+#define SLIDEBUNDLE_H
+
+#include <QFile>
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <QVector>
+
+/* The layout of a slide bundle, in the byte order of the machine writing it:
+     SlideBundleHeader
+     SlideBundleEntry[count]
+     the pixel blocks, each starting at a SLIDE_BUNDLE_BLOCK_ALIGN boundary, of
+     rows padded to SLIDE_BUNDLE_ROW_ALIGN bytes of premultiplied ARGB32 pixels. */
+#define SLIDE_BUNDLE_MAGIC        "SWBUNDLE"
+#define SLIDE_BUNDLE_VERSION      1
+#define SLIDE_BUNDLE_BYTE_ORDER   0x01020304  /* Read back differently on a machine of the other byte order. */
+#define SLIDE_BUNDLE_BLOCK_ALIGN  4096        /* A page, so each slide maps on its own pages. */
+#define SLIDE_BUNDLE_ROW_ALIGN    16
+
+/*! \struct SlideBundleHeader
+    \brief The header of a slide bundle.
+*/
+struct SlideBundleHeader
+{
+    char magic[8];      /*!< SLIDE_BUNDLE_MAGIC, not terminated. */
+    quint32 version;    /*!< SLIDE_BUNDLE_VERSION. */
+    quint32 byteOrder;  /*!< SLIDE_BUNDLE_BYTE_ORDER. */
+    quint32 count;      /*!< The number of slides. */
+    quint32 width;      /*!< The window size the slides are scaled for. */
+    quint32 height;
+    quint32 reserved;
+};
+
+/*! \struct SlideBundleEntry
+    \brief The place and geometry of a slide in a slide bundle.
+*/
+struct SlideBundleEntry
+{
+    quint64 offset;        /*!< The start of the pixel block from the start of the file. */
+    quint32 width;
+    quint32 height;
+    quint32 bytesPerLine;
+    quint32 reserved;
+};
+
+/*! \class SlideBundle
+    \brief A slide bundle mapped into memory, its slides are images on the mapping.
+
+    Opening a bundle reads its header and offset table only, and showing a
+    slide neither decodes nor copies it until it is turned into a pixmap.
+*/
+class SlideBundle
+{
+public:
+    SlideBundle();   /*!< Constructor */
+    ~SlideBundle();  /*!< Destructor */
+
+    bool open(const QString &fileName);  /*!< Map a slide bundle. */
+    void close();
+    bool isOpen() const;
+
+    int count() const;
+    QSize targetSize() const;  /*!< The window size the slides are scaled for. */
+    QSize slideSize(int index) const;
+    QImage slide(int index) const;  /*!< A read-only image on the mapping. */
+
+private:
+    QFile m_file;
+    uchar *m_data;      /*!< The mapping of the whole file, NULL when closed. */
+    const SlideBundleHeader *m_header;
+    const SlideBundleEntry *m_entries;
+};
+
+/*! \class SlideBundleWriter
+    \brief Write a slide bundle, one slide at a time.
+*/
+class SlideBundleWriter
+{
+public:
+    SlideBundleWriter(const QString &fileName, const QSize &targetSize, int count);  /*!< Constructor */
+
+    bool addSlide(const QImage &image);  /*!< Append a slide, converted to premultiplied ARGB32. */
+    bool finish();  /*!< Write the offset table, false if not all slides were added. */
+
+private:
+    QFile m_file;
+    SlideBundleHeader m_header;
+    QVector<SlideBundleEntry> m_entries;
+    int m_nAdded;
+    bool m_bFailed;
+};
+
+#endif /* SLIDEBUNDLE_H */
@@ -0,0 +1,197 @@
+/*! \file  SlideCache.cpp
+    \brief Implementation of SlideCache class.
+ */
+
+#include <QtGlobal>
+#include <string.h>
+
+#include "SlideCache.h"
+
+/* zlib's fastest level, the slides are compressed once and inflated many times. */
+#define PACK_COMPRESSION_LEVEL  1
+
+/*! \struct PackedSlideHeader
+    \brief The geometry in front of the compressed pixels of a packed slide.
+*/
+struct PackedSlideHeader
+{
+    quint32 width;
+    quint32 height;
+    quint32 opaque;  /*!< 1 for RGB888 pixels of an RGB32 slide, 0 for premultiplied ARGB32 ones. */
+};
+
+/*! \fn SlideCache::SlideCache(int maxKBytes)
+    \brief Constructor
+
+    \param[in] maxKBytes the budget of the packed slides in kilobytes.
+ */
+SlideCache::SlideCache(int maxKBytes)
+    : m_cache(maxKBytes)
+    , m_nHits(0)
+    , m_nMisses(0)
+{
+}
+
+/*! \fn void SlideCache::setMaxKBytes(int maxKBytes)
+    \brief Set the budget of the packed slides, dropping the least recently used ones beyond it.
+
+    \param[in] maxKBytes the budget in kilobytes.
+    \return NONE.
+ */
+void SlideCache::setMaxKBytes(int maxKBytes)
+{
+    m_cache.setMaxCost(qMax(0, maxKBytes));
+}
+
+/*! \fn int SlideCache::maxKBytes() const
+    \brief Return the budget of the packed slides.
+
+    \param[in] NONE.
+    \return the budget in kilobytes.
+ */
+int SlideCache::maxKBytes() const
+{
+    return m_cache.maxCost();
+}
+
+/*! \fn int SlideCache::totalKBytes() const
+    \brief Return the size of the packed slides kept.
+
+    \param[in] NONE.
+    \return the size in kilobytes.
+ */
+int SlideCache::totalKBytes() const
+{
+    return m_cache.totalCost();
+}
+
+/*! \fn void SlideCache::insert(int index, const QByteArray &packed)
+    \brief Keep a packed slide, unless it is larger than the whole budget.
+
+    \param[in] index the index of the slide.
+    \param[in] packed the slide packed by pack().
+    \return NONE.
+ */
+void SlideCache::insert(int index, const QByteArray &packed)
+{
+    if (packed.isEmpty())
+       return;
+
+    m_cache.insert(index, new QByteArray(packed), packed.size() / 1024 + 1);
+}
+
+/*! \fn bool SlideCache::take(int index, QByteArray &packed)
+    \brief Take a slide out of the cache, it is inserted again when the view releases it.
+
+    \param[in] index the index of the slide.
+    \param[out] packed the packed slide when found.
+    \return true on a hit.
+ */
+bool SlideCache::take(int index, QByteArray &packed)
+{
+    QByteArray *cached = m_cache.take(index);
+
+    if (cached == NULL)
+    {
+       m_nMisses++;
+       return false;
+    }
+
+    m_nHits++;
+    packed = *cached;
+    delete cached;
+
+    return true;
+}
+
+/*! \fn void SlideCache::clear()
+    \brief Drop all packed slides, e.g. when the slides are scaled for another window size.
+
+    \param[in] NONE.
+    \return NONE.
+ */
+void SlideCache::clear()
+{
+    m_cache.clear();
+}
+
+/*! \fn int SlideCache::hits() const
+    \brief Return the number of slides found by take().
+
+    \param[in] NONE.
+    \return the hits.
+ */
+int SlideCache::hits() const
+{
+    return m_nHits;
+}
+
+/*! \fn int SlideCache::misses() const
+    \brief Return the number of slides not found by take(), read from their files instead.
+
+    \param[in] NONE.
+    \return the misses.
+ */
+int SlideCache::misses() const
+{
+    return m_nMisses;
+}
+
+/*! \fn QByteArray SlideCache::pack(const QImage &image)
+    \brief Compress the pixels of a slide, opaque ones without their padding byte.
+
+    \param[in] image the slide.
+    \return the packed slide, empty for a null image.
+ */
+QByteArray SlideCache::pack(const QImage &image)
+{
+    if (image.isNull())
+       return QByteArray();
+
+    PackedSlideHeader header;
+    header.width = image.width();
+    header.height = image.height();
+    header.opaque = image.hasAlphaChannel() ? 0 : 1;
+
+    const QImage source = image.convertToFormat(header.opaque ? QImage::Format_RGB888 : QImage::Format_ARGB32_Premultiplied);
+    const int rowSize = image.width() * (header.opaque ? 3 : 4);
+
+    /* The rows without their alignment padding. */
+    QByteArray pixels;
+    pixels.resize(rowSize * image.height());
+    for (int y = 0; y < image.height(); y++)
+       memcpy(pixels.data() + y * rowSize, source.constScanLine(y), rowSize);
+
+    QByteArray packed(reinterpret_cast<const char *>(&header), sizeof(header));
+    packed += qCompress(pixels, PACK_COMPRESSION_LEVEL);
+
+    return packed;
+}
+
+/*! \fn QImage SlideCache::unpack(const QByteArray &packed)
+    \brief Inflate a packed slide.
+
+    \param[in] packed the slide packed by pack().
+    \return the slide, RGB32 or premultiplied ARGB32, null if the data is broken.
+ */
+QImage SlideCache::unpack(const QByteArray &packed)
+{
+    if (packed.size() <= (int)sizeof(PackedSlideHeader))
+       return QImage();
+
+    PackedSlideHeader header;
+    memcpy(&header, packed.constData(), sizeof(header));
+
+    const int rowSize = header.width * (header.opaque ? 3 : 4);
+    QByteArray pixels = qUncompress(reinterpret_cast<const uchar *>(packed.constData()) + sizeof(header),
+                                    packed.size() - sizeof(header));
+
+    if (pixels.size() != rowSize * (int)header.height)
+       return QImage();
+
+    QImage image(header.width, header.height, header.opaque ? QImage::Format_RGB888 : QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < image.height(); y++)
+       memcpy(image.scanLine(y), pixels.constData() + y * rowSize, rowSize);
+
+    return header.opaque ? image.convertToFormat(QImage::Format_RGB32) : image;
+}
@@ -0,0 +1,49 @@
+/*! \file  SlideCache.h
+    \brief Declaration of SlideCache class.
+ */
+
+#ifndef SLIDECACHE_H
+#define SLIDECACHE_H
+
+#include <QByteArray>
+#include <QCache>
+#include <QImage>
+
+#define DFLT_SLIDE_CACHE_KBYTES  32768  /* The default budget of the compressed slides. */
+
+/*! \class SlideCache
+    \brief The middle tier between the decoded slides and the picture files.
+
+    It keeps the scaled pixels of slides released from the view, compressed,
+    within a budget in kilobytes, and drops the least recently used first.
+    A slide is taken out while it is back in the view, so the budget only
+    counts the slides which are not decoded.
+    Unpacking a slide is an inflate and a copy, with no file I/O nor JPEG
+    decode nor scaling.
+*/
+class SlideCache
+{
+public:
+    SlideCache(int maxKBytes = DFLT_SLIDE_CACHE_KBYTES);  /*!< Constructor */
+
+    void setMaxKBytes(int maxKBytes);
+    int maxKBytes() const;
+    int totalKBytes() const;
+
+    void insert(int index, const QByteArray &packed);  /*!< Keep a released slide packed by pack(). */
+    bool take(int index, QByteArray &packed);  /*!< Take a slide out for the view, counting the hits and misses. */
+    void clear();
+
+    int hits() const;
+    int misses() const;
+
+    static QByteArray pack(const QImage &image);  /*!< Compress a slide, on a decoder thread. */
+    static QImage unpack(const QByteArray &packed);  /*!< Restore a packed slide, on a decoder thread. */
+
+private:
+    QCache<int, QByteArray> m_cache;  /*!< The packed slides by index, the cost is their size in kilobytes. */
+    int m_nHits;
+    int m_nMisses;
+};
+
+#endif /* SLIDECACHE_H */
@@ -0,0 +1,406 @@
+/*! \file  SlideLoader.cpp
+    \brief Implementation of SlideLoader class.
+ */
+
+#include <QImageReader>
+#include <QMutexLocker>
+#include <QtGlobal>
+
+#include <QFile>
+#include <QBuffer>
+
+#if defined(Q_OS_LINUX)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "SlideLoader.h"
+#include "ImageScaler.h"
+#include "ExifReader.h"
+#include "SlideCache.h"
+
+#define DECODER_NICE  10  /* The nice value of the decoders, the GUI thread stays at 0. */
+#define READ_AHEAD_FILES  2  /* The pending pictures read ahead when a decoder takes a job. */
+
+/*! \fn SlideDecoder::SlideDecoder(SlideLoader *loader)
+    \brief Constructor
+
+    \param[in] loader the scheduler handing out the jobs.
+ */
+SlideDecoder::SlideDecoder(SlideLoader *loader)
+    : QThread()
+    , m_loader(loader)
+{
+}
+
+/*! \fn static void readAhead(const QString &fileName)
+    \brief Ask the kernel to read a file into the page cache in the background.
+
+    The file is not mapped yet, so the hint goes through its descriptor
+    rather than madvise() on a mapping.
+
+    \param[in] fileName the file to be read soon.
+    \return NONE.
+ */
+static void readAhead(const QString &fileName)
+{
+#if defined(Q_OS_LINUX)
+    int fd = ::open(QFile::encodeName(fileName).constData(), O_RDONLY);
+    if (fd < 0)
+       return;
+
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    ::close(fd);
+#else
+    Q_UNUSED(fileName);
+#endif
+}
+
+/*! \fn static QImage decodeSlide(QIODevice *device, const QSize &slideSize)
+    \brief Decode a picture, scale it to its slide and turn it upright.
+
+    \param[in] device the JPEG or PNG stream, positioned at its start.
+    \param[in] slideSize the upright size of the slide.
+    \return the slide, null if the picture could not be decoded.
+ */
+static QImage decodeSlide(QIODevice *device, const QSize &slideSize)
+{
+    ExifReader exif(device);
+    device->seek(0);
+
+    QImageReader reader(device);
+
+    #if QT_VERSION >= 0x050500
+    reader.setAutoTransform(false);  /* Turned upright below, once scaled. */
+    #endif
+
+    QImage image = reader.read();
+
+    /* The slide size is upright, the decoded picture is as stored. */
+    QSize size = slideSize;
+    if (ExifReader::isTransposed(exif.orientation()))
+       size.transpose();
+
+    /* The decoders already share the cores, scale on this thread only. */
+    if (!image.isNull() && image.size() != size)
+       image = ImageScaler::scaled(image, size, false);
+
+    /* Turning the scaled picture upright costs a pass over the slide, not over the photo. */
+    if (!image.isNull() && exif.orientation() != 1)
+       image = image.transformed(ExifReader::orientationTransform(exif.orientation()));
+
+    return image;
+}
+
+/*! \fn static QImage scaleThumbnail(const QImage &slide, const QSize &box)
+    \brief Scale a decoded slide down to a thumbnail, on the decoder thread.
+
+    \param[in] slide the slide.
+    \param[in] box the largest size of the thumbnail, empty for none.
+    \return the thumbnail, null without a box.
+ */
+static QImage scaleThumbnail(const QImage &slide, const QSize &box)
+{
+    if (slide.isNull() || box.isEmpty())
+       return QImage();
+
+    QSize size = slide.size().scaled(box, Qt::KeepAspectRatio).boundedTo(slide.size());
+    if (size.isEmpty())
+       return QImage();
+
+    /* The decoders already share the cores, scale on this thread only. */
+    return ImageScaler::scaled(slide, size, false);
+}
+
+/*! \fn void SlideDecoder::run()
+    \brief Decode and scale the most urgent job until the loader quits.
+
+    The picture is decoded straight from a read-only mapping of its file, so
+    there is no read() per buffer and no copy into a file buffer, and the
+    kernel may drop its clean pages under memory pressure.
+
+    \param[in] NONE.
+    \return NONE.
+ */
+void SlideDecoder::run()
+{
+#if defined(Q_OS_LINUX)
+    /* Linux's default scheduler ignores QThread priorities, so lower the nice value of this thread. */
+    setpriority(PRIO_PROCESS, syscall(SYS_gettid), DECODER_NICE);
+#endif
+
+    SlideJob job;
+    QStringList nextFiles;
+
+    while (m_loader->takeJob(job, nextFiles))
+    {
+       /* Read the next pictures in scroll order while this one decodes. */
+       foreach (const QString &fileName, nextFiles)
+          readAhead(fileName);
+
+       QImage image;
+       QByteArray packed;
+
+       /* A slide from the compressed tier is only inflated, and handed back packed for when it is released again. */
+       if (!job.packed.isEmpty())
+       {
+          image = SlideCache::unpack(job.packed);
+          emit decoded(job.index, job.generation, image, job.packed, scaleThumbnail(image, job.thumbSize));
+          continue;
+       }
+
+       QFile file(job.fileName);
+       uchar *data = NULL;
+
+       if (file.open(QIODevice::ReadOnly) && file.size() > 0)
+          data = file.map(0, file.size());
+
+       if (data != NULL)
+       {
+          #if defined(Q_OS_LINUX)
+          /* The decoder reads the file once from start to end. */
+          madvise(data, file.size(), MADV_SEQUENTIAL);
+          madvise(data, file.size(), MADV_WILLNEED);
+          #endif
+
+          QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char *>(data), file.size());
+          QBuffer buffer(&bytes);
+          buffer.open(QIODevice::ReadOnly);
+
+          image = decodeSlide(&buffer, job.size);
+          file.unmap(data);
+       }
+       else if (file.isOpen())
+       {
+          /* E.g. a file system without mmap support. */
+          image = decodeSlide(&file, job.size);
+       }
+
+       /* Packed here at low priority, kept by the GUI thread for when the slide comes back. */
+       if (job.wantPacked)
+          packed = SlideCache::pack(image);
+
+       emit decoded(job.index, job.generation, image, packed, scaleThumbnail(image, job.thumbSize));
+    }
+}
+
+/*! \fn SlideLoader::SlideLoader(int radius, QObject *parent)
+    \brief Constructor, start one decoder per core but the GUI thread's.
+
+    \param[in] radius the farthest distance from the view, in slides, worth decoding.
+    \param[in] parent the parent object.
+ */
+SlideLoader::SlideLoader(int radius, QObject *parent)
+    : QObject(parent)
+    , m_nCurrent(0)
+    , m_nPredicted(0)
+    , m_bQuit(false)
+    , m_nRadius(radius)
+    , m_nGeneration(0)
+{
+    int nDecoders = qMax(1, QThread::idealThreadCount() - 1);
+
+    for (int i = 0; i < nDecoders; i++)
+    {
+       SlideDecoder *decoder = new SlideDecoder(this);
+
+       /* The results are delivered on the GUI thread, see onDecoded(). */
+       QObject::connect(decoder, SIGNAL(decoded(int, int, QImage, QByteArray, QImage)), this, SLOT(onDecoded(int, int, QImage, QByteArray, QImage)),
+                        Qt::QueuedConnection);
+
+       decoder->start(QThread::LowPriority);
+       m_decoders << decoder;
+    }
+}
+
+/*! \fn SlideLoader::~SlideLoader()
+    \brief Destructor, wait for the decoders to finish their jobs in progress.
+ */
+SlideLoader::~SlideLoader()
+{
+    m_mutex.lock();
+    m_bQuit = true;
+    m_jobs.clear();
+    m_jobQueued.wakeAll();
+    m_mutex.unlock();
+
+    foreach (SlideDecoder *decoder, m_decoders)
+       decoder->wait();
+
+    qDeleteAll(m_decoders);
+}
+
+/*! \fn void SlideLoader::request(int index, const QString &fileName, const QSize &size, bool wantPacked, const QSize &thumbSize, const QByteArray &packed)
+    \brief Queue a slide to decode, unless it is queued or being decoded already.
+
+    \param[in] index the index of the slide.
+    \param[in] fileName the picture file.
+    \param[in] size the size the picture is scaled to.
+    \param[in] wantPacked true to pack the decoded slide for SlideCache, false to skip the compression.
+    \param[in] thumbSize the box to scale a thumbnail of the slide into, empty for none.
+    \param[in] packed the slide packed by SlideCache, to inflate instead of decoding the file.
+    \return NONE.
+ */
+void SlideLoader::request(int index, const QString &fileName, const QSize &size, bool wantPacked, const QSize &thumbSize, const QByteArray &packed)
+{
+    if (m_requested.contains(index))
+       return;
+
+    SlideJob job;
+    job.index = index;
+    job.fileName = fileName;
+    job.size = size;
+    job.packed = packed;
+    job.wantPacked = wantPacked;
+    job.thumbSize = thumbSize;
+    job.generation = m_nGeneration;
+
+    QMutexLocker locker(&m_mutex);
+    m_jobs.insert(index, job);
+    m_requested.insert(index);
+    m_jobQueued.wakeOne();
+}
+
+/*! \fn bool SlideLoader::isRequested(int index) const
+    \brief Check if a slide is queued or being decoded.
+
+    \param[in] index the index of the slide.
+    \return true if the slide will be delivered by slideLoaded().
+ */
+bool SlideLoader::isRequested(int index) const
+{
+    return m_requested.contains(index);
+}
+
+/*! \fn void SlideLoader::setFocus(int current, int predicted)
+    \brief Reorder the jobs for a new view position, and cancel the ones too far from it.
+
+    A cancelled job holding a packed slide hands it back by slideCancelled(),
+    it was taken out of SlideCache and would be lost with the job otherwise.
+
+    \param[in] current the slide under the view.
+    \param[in] predicted the slide the view is heading to, e.g. where a flick stops.
+    \return NONE.
+ */
+void SlideLoader::setFocus(int current, int predicted)
+{
+    QMap<int, QByteArray> cancelled;
+
+    m_mutex.lock();
+
+    m_nCurrent = current;
+    m_nPredicted = predicted;
+
+    QMap<int, SlideJob>::iterator it = m_jobs.begin();
+    while (it != m_jobs.end())
+    {
+       if (priority(it.key()) > m_nRadius)
+       {
+          if (!it.value().packed.isEmpty())
+             cancelled.insert(it.key(), it.value().packed);
+
+          m_requested.remove(it.key());
+          it = m_jobs.erase(it);
+       }
+       else
+       {
+          ++it;
+       }
+    }
+
+    m_mutex.unlock();
+
+    /* Outside the lock, the receiver may queue jobs again. */
+    for (QMap<int, QByteArray>::const_iterator packed = cancelled.constBegin(); packed != cancelled.constEnd(); ++packed)
+       emit slideCancelled(packed.key(), packed.value());
+}
+
+/*! \fn void SlideLoader::clear()
+    \brief Cancel all jobs, and drop the results of the ones being decoded, e.g. after a resize.
+
+    \param[in] NONE.
+    \return NONE.
+ */
+void SlideLoader::clear()
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_jobs.clear();
+    m_requested.clear();
+    m_nGeneration++;
+}
+
+/*! \fn bool SlideLoader::takeJob(SlideJob &job, QStringList &nextFiles)
+    \brief Wait for a job and take the most urgent one, called by the decoders.
+
+    \param[out] job the job to decode.
+    \param[out] nextFiles the files of the next READ_AHEAD_FILES pending jobs, most urgent first.
+    \return false when the loader quits.
+ */
+bool SlideLoader::takeJob(SlideJob &job, QStringList &nextFiles)
+{
+    QMutexLocker locker(&m_mutex);
+
+    while (m_jobs.isEmpty() && !m_bQuit)
+       m_jobQueued.wait(&m_mutex);
+
+    if (m_bQuit)
+       return false;
+
+    /* A handful of jobs are near the view at most, a linear scan is enough. */
+    QMap<int, SlideJob>::iterator best = m_jobs.begin();
+    for (QMap<int, SlideJob>::iterator it = m_jobs.begin(); it != m_jobs.end(); ++it)
+    {
+       if (priority(it.key()) < priority(best.key()))
+          best = it;
+    }
+
+    job = best.value();
+    m_jobs.erase(best);
+
+    /* The next jobs in scroll order, to read their files ahead. */
+    QMultiMap<int, QString> byPriority;
+    for (QMap<int, SlideJob>::const_iterator it = m_jobs.constBegin(); it != m_jobs.constEnd(); ++it)
+    {
+       if (it.value().packed.isEmpty())
+          byPriority.insert(priority(it.key()), it.value().fileName);
+    }
+
+    nextFiles = byPriority.values().mid(0, READ_AHEAD_FILES);
+
+    return true;
+}
+
+/*! \fn int SlideLoader::priority(int index) const
+    \brief The distance of a slide from the view or from where it is heading, lower is sooner.
+
+    \param[in] index the index of the slide.
+    \return the priority.
+ */
+int SlideLoader::priority(int index) const
+{
+    return qMin(qAbs(index - m_nCurrent), qAbs(index - m_nPredicted));
+}
+
+/*! \fn void SlideLoader::onDecoded(int index, int generation, const QImage &image, const QByteArray &packed, const QImage &thumbnail)
+    \brief Deliver a decoded slide on the GUI thread, unless clear() was called since it was requested.
+
+    \param[in] index the index of the slide.
+    \param[in] generation the layout the job was requested for.
+    \param[in] image the scaled picture, null if it could not be decoded.
+    \param[in] packed the picture packed by SlideCache, empty if it was not wanted.
+    \param[in] thumbnail the thumbnail of the picture, null if it was not wanted.
+    \return NONE.
+ */
+void SlideLoader::onDecoded(int index, int generation, const QImage &image, const QByteArray &packed, const QImage &thumbnail)
+{
+    if (generation != m_nGeneration)
+       return;
+
+    m_requested.remove(index);
+
+    emit slideLoaded(index, image, packed, thumbnail);
+}
@@ -0,0 +1,105 @@
+/*! \file  SlideLoader.h
+    \brief Declaration of SlideLoader class.
+ */
+
+#ifndef SLIDELOADER_H
+#define SLIDELOADER_H
+
+#include <QObject>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QImage>
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QSize>
+#include <QMap>
+#include <QSet>
+#include <QList>
+
+/*! \struct SlideJob
+    \brief A picture to decode and scale to its slide size.
+*/
+struct SlideJob
+{
+    int index;         /*!< The index of the slide. */
+    QString fileName;  /*!< The picture file. */
+    QSize size;        /*!< The size the picture is scaled to. */
+    QByteArray packed; /*!< The slide packed by SlideCache, the file is decoded when empty. */
+    bool wantPacked;   /*!< Pack the decoded slide for the compressed tier, false when it has no budget. */
+    QSize thumbSize;   /*!< The box the thumbnail of the slide is scaled into, empty for no thumbnail. */
+    int generation;    /*!< The layout the job was requested for. */
+};
+
+class SlideLoader;
+
+/*! \class SlideDecoder
+    \brief A worker thread decoding the most urgent job of a SlideLoader, at low priority.
+*/
+class SlideDecoder : public QThread
+{
+Q_OBJECT
+
+public:
+    SlideDecoder(SlideLoader *loader);  /*!< Constructor */
+
+signals:
+    void decoded(int index, int generation, const QImage &image, const QByteArray &packed, const QImage &thumbnail);
+
+protected:
+    void run();
+
+private:
+    SlideLoader *m_loader;
+};
+
+/*! \class SlideLoader
+    \brief The scheduler decoding the slides off the GUI thread, nearest to the view first.
+
+    A job's priority is its distance from the slide under the view or from
+    the slide the view is heading to, whichever is nearer. The pending jobs
+    are ordered again whenever the view moves, and the ones farther than the
+    load radius from both are cancelled before a decoder takes them.
+*/
+class SlideLoader : public QObject
+{
+Q_OBJECT
+
+public:
+    SlideLoader(int radius, QObject *parent = 0);  /*!< Constructor */
+    ~SlideLoader();  /*!< Destructor */
+
+    void request(int index, const QString &fileName, const QSize &size, bool wantPacked,
+                 const QSize &thumbSize = QSize(), const QByteArray &packed = QByteArray());  /*!< Queue a slide to decode. */
+    bool isRequested(int index) const;  /*!< Whether a slide is queued or being decoded. */
+    void setFocus(int current, int predicted);  /*!< Reorder the jobs for a new view position. */
+    void clear();  /*!< Cancel all jobs and drop the results in progress. */
+
+signals:
+    void slideLoaded(int index, const QImage &image, const QByteArray &packed, const QImage &thumbnail);
+    void slideCancelled(int index, const QByteArray &packed);  /*!< The packed slide of a cancelled job, handed back. */
+
+private slots:
+    void onDecoded(int index, int generation, const QImage &image, const QByteArray &packed, const QImage &thumbnail);
+
+private:
+    friend class SlideDecoder;
+
+    bool takeJob(SlideJob &job, QStringList &nextFiles);  /*!< Wait for the most urgent job, false when quitting. */
+    int priority(int index) const;
+
+    QMutex m_mutex;              /*!< Guards the members below shared with the decoders. */
+    QWaitCondition m_jobQueued;
+    QMap<int, SlideJob> m_jobs;  /*!< The jobs no decoder has taken yet, by slide index. */
+    int m_nCurrent;              /*!< The slide under the view. */
+    int m_nPredicted;            /*!< The slide the view is heading to. */
+    bool m_bQuit;
+
+    int m_nRadius;               /*!< The farthest distance from the focus worth decoding. */
+    int m_nGeneration;           /*!< Bumped by clear(), older results are dropped. */
+    QSet<int> m_requested;       /*!< The slides queued or being decoded, GUI thread only. */
+    QList<SlideDecoder*> m_decoders;
+};
+
+#endif /* SLIDELOADER_H */
@@ -12,137 +12,1188 @@
 #include <QDir>
 #include <QStringList>
 #include <QPixmap>
+#include <QImageReader>
+#include <QFileInfo>
+#include <QSettings>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QDesktopWidget>
+
+#if QT_VERSION >= 0x050000
+#include <QStandardPaths>
+#else
+#include <QDesktopServices>
+#endif
+
+#ifdef Q_WS_X11
+#include <QX11Info>
+#elif defined(HAVE_X11EXTRAS)
+#include <QtX11Extras/QX11Info>
+#if QT_VERSION < 0x050700
+#include <stdlib.h>
+#include <xcb/xcb.h>
+#endif
+#endif
 #include <QDebug>
+#include <QPainter>
+#include <QPixmapCache>
+#include <QStyleOptionGraphicsItem>
+#include <QGestureEvent>
+#include <QPinchGesture>
+#include <qmath.h>
 #include <QtGlobal>  // Add for Qt5, 2015-09-10.
 
 #include "SlidingWindow.h"
+#include "ExifReader.h"
 
-/* The dimension of the main window. */
+/* The default dimension of the main window. */
 #define MAIN_WIN_WIDTH  1024
 #define MAIN_WIN_HEIGHT  600
 
-#define SLIDE_OFFSET MAIN_WIN_WIDTH  /* The moving offset. */
+/* The optional configuration file overriding the default geometry, e.g.
+     [Window]
+     Width=800
+     Height=480
+     FitScreen=false
+     [Layout]
+     AnimationDuration=500
+     Images=signage.bundle
+     [Render]
+     Profile=lowpower
+     ReportFrameTime=true
+     [Cache]
+     ResidentRadius=3
+     CompressedKB=32768
+     ReportHitRate=true
+     [Memory]
+     LowKB=131072
+     CriticalKB=49152
+     PollInterval=2000
+     [DeepZoom]
+     CacheDir=/var/cache/slidingwindow/tiles
+     CacheMB=256
+     TileCacheKB=32768
+     BuildBufferKB=65536
+ */
+#define DFLT_CONFIG_FILE "SlidingWindow.ini"
+
+#define DFLT_RENDER_PROFILE "default"  /* "default", "lowpower" or "quality", see RenderProfile. */
+#define FRAME_TIME_REPORT_FRAMES 100   /* Print the painting time every that many frames. */
+#define BENCHMARK_SETTLE_TIME 1000     /* The wait in milliseconds before a benchmark, for the first pictures. */
 
-#ifdef USE_CONTROL_PANEL
 #define CTRL_PANEL_POS_X 570
 #define CTRL_PANEL_POS_Y 640
 
 #define ITEM_POS_START_X  0    /* The x-axis value for the first item. */
-#define ANIMATION_DURATION 500
+
+#define ANIMATION_DURATION 500  /* The default animation duration in milliseconds. */
+
+#define DFLT_IMG_DIR "images"  /* The default folder containing images, or a slide bundle file. */
+
+#define PAGE_NUM_POS_OFFSET_X  50
+#define PAGE_NUM_POS_OFFSET_Y  30
+#define PAGE_NUM_GLYPHS        "P.0123456789"  /* All characters of page numbers. */
+
+#define VISIBLE_SLIDE_MARGIN  1  /* The slides kept in the scene on both sides of the view. */
+#define SLIDE_LOAD_RADIUS     2  /* The slides decoded on both sides of the view and of where it is heading. */
+#define SLIDE_KEEP_RADIUS     3  /* The default distance beyond which the slides release their pictures. */
+#define CACHE_REPORT_LOOKUPS 50  /* Print the hit rate of the compressed tier every that many lookups. */
+#define LOW_MEM_CACHE_SHARE   4  /* Under low memory pressure the compressed tier keeps 1/4 of its budget. */
+
+#define TILE_CACHE_FOLDER        "tiles"  /* The folder of the tile pyramids under the cache location of the application. */
+#define DFLT_TILE_DISK_MBYTES    256      /* The default disk space of the tile pyramids. */
+#define DFLT_TILE_CACHE_KBYTES   32768    /* The default memory for the tiles of the zoomed picture. */
+#define DFLT_TILE_BUFFER_KBYTES  65536    /* The default memory for a band of a picture while building its pyramid. */
+
+#define DEBUG   // To show debugging messages.
+
+/*! \fn static bool isCompositingManagerRunning()
+    \brief Check if a compositing manager blends translucent windows with what is behind them.
+
+    \param[in] NONE.
+    \return true if translucent windows are composited.
+ */
+static bool isCompositingManagerRunning()
+{
+#if defined(Q_WS_X11)
+    return QX11Info::isCompositingManagerRunning();
+#elif defined(HAVE_X11EXTRAS) && QT_VERSION >= 0x050200
+    /* E.g. Wayland, which composites every window. */
+    if (!QX11Info::isPlatformX11())
+       return true;
+
+    #if QT_VERSION >= 0x050700
+    return QX11Info::isCompositingManagerRunning();
+    #else
+    /* A compositing manager owns the _NET_WM_CM_S<screen> selection, as QX11Info checks since Qt 5.7. */
+    xcb_connection_t *connection = QX11Info::connection();
+    QByteArray name = "_NET_WM_CM_S" + QByteArray::number(QX11Info::appScreen());
+
+    xcb_intern_atom_reply_t *atom = xcb_intern_atom_reply(connection, xcb_intern_atom(connection, 0, name.length(), name.constData()), NULL);
+    if (atom == NULL)
+       return false;
+
+    xcb_get_selection_owner_reply_t *owner = xcb_get_selection_owner_reply(connection, xcb_get_selection_owner(connection, atom->atom), NULL);
+    bool running = (owner != NULL && owner->owner != XCB_NONE);
+
+    free(owner);
+    free(atom);
+    return running;
+    #endif
+#else
+    /* Other window systems, or Qt5 built without QtX11Extras, cannot be asked here; assume they composite. */
+    return true;
 #endif
+}
+
+/*! \fn static void applyRenderProfile(QGraphicsView *view, RenderProfile profile)
+    \brief Set the viewport update mode, optimization flags, cache mode and render hints of a view.
+
+    \param[in] view the view to tune.
+    \param[in] profile the rendering profile.
+    \return NONE.
+ */
+static void applyRenderProfile(QGraphicsView *view, RenderProfile profile)
+{
+    switch (profile)
+    {
+    case RENDER_LOW_POWER:
+       /* One repaint rectangle around all changes, no painter state saved or
+          adjusted per item (items restore what they change), no antialiasing. */
+       view->setViewportUpdateMode(QGraphicsView::BoundingRectViewportUpdate);
+       view->setOptimizationFlags(QGraphicsView::DontSavePainterState | QGraphicsView::DontAdjustForAntialiasing);
+       view->setCacheMode(QGraphicsView::CacheBackground);
+       view->setRenderHints(QPainter::RenderHints());
+       break;
+
+    case RENDER_QUALITY:
+       view->setViewportUpdateMode(QGraphicsView::MinimalViewportUpdate);
+       view->setOptimizationFlags(QGraphicsView::OptimizationFlags());
+       view->setCacheMode(QGraphicsView::CacheNone);
+       view->setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform | QPainter::TextAntialiasing);
+       break;
+
+    default:
+       /* Qt's defaults. */
+       view->setViewportUpdateMode(QGraphicsView::MinimalViewportUpdate);
+       view->setOptimizationFlags(QGraphicsView::OptimizationFlags());
+       view->setCacheMode(QGraphicsView::CacheNone);
+       view->setRenderHints(QPainter::TextAntialiasing);
+       break;
+    }
+}
+
+/*! \fn SlidingWindow::SlidingWindow(int options)
+    \brief Constructor
+
+    \param[in] options the switched on features, OR-ed SlidingWindowOption values.
+ */
+SlidingWindow::SlidingWindow(int options)
+    : QGraphicsView()
+    , m_background(NULL)
+    , m_nAnimationDuration(ANIMATION_DURATION)
+    , m_renderProfile(RENDER_DEFAULT)
+    , m_bReportFrameTime(false)
+    , m_nBenchSweeps(0)
+    , m_nBenchStep(-1)
+    , m_nOptions(options)
+    , m_nStripOffset(0)
+    , m_nFirstInScene(-1)
+    , m_nLastInScene(-1)
+    , m_slideLoader(SLIDE_LOAD_RADIUS)
+    , m_nResidentRadius(SLIDE_KEEP_RADIUS)
+    , m_nCacheKBytes(DFLT_SLIDE_CACHE_KBYTES)
+    , m_nKeepRadius(SLIDE_KEEP_RADIUS)
+    , m_bReportCacheHits(false)
+    , m_nMemPollInterval(DFLT_MEM_POLL_INTERVAL)
+    , m_nScrollSpeed(0)
+    , m_bJumping(false)
+    , m_scrubber(NULL)
+    , m_bScrubbing(false)
+    , m_deepZoom(NULL)
+    , m_nTileDiskMBytes(DFLT_TILE_DISK_MBYTES)
+    , m_nTileCacheKBytes(DFLT_TILE_CACHE_KBYTES)
+    , m_nTileBufferKBytes(DFLT_TILE_BUFFER_KBYTES)
+    , m_pageNumItem(NULL)
+    , m_nNewPosOfFirstItem(0)
+    , m_flickcharm(this, FLICK_HORIZONTAL)
+{
+    /* Set the view widget to be frameless. */
+    setWindowFlags(Qt::FramelessWindowHint);
+
+    /* A translucent window is rendered into an ARGB32 backing store and blended
+       every frame, which is wasted without a compositing manager to show it. */
+    if (testOption(SW_TRANSPARENT_FRAME) && !isCompositingManagerRunning())
+    {
+       #ifdef DEBUG
+       qDebug("%s : %s(%d) - No compositing manager, use an opaque window.", __FILE__, __FUNCTION__, __LINE__);
+       #endif
+
+       m_nOptions &= ~SW_TRANSPARENT_FRAME;
+    }
 
-#define DFLT_IMG_DIR "images"  /* The default folder containing images. */
+    if (testOption(SW_TRANSPARENT_FRAME))
+    {
+       /* To set the scene's background to be transparent */
+       /* LOOK! In Linux, this will take effect only when
+           COMPIZ(compositing manager) turns on. */
+       /* When using this line, it must set WindowFlags "Qt::FramelessWindowHint" */
+       setAttribute(Qt::WA_TranslucentBackground);
+
+       /* There are three ways to achieve transparent window frame effect. */
+       #if 0
+       /* <Way - 1> */
+       viewport()->setAutoFillBackground(false);
+       #elif 1
+       /* <Way - 2>. */
+       QPalette p = viewport()->palette();
+       p.setColor(QPalette::Base, Qt::transparent);
+       viewport()->setPalette(p);
+       #elif 0
+       /* <Way - 3>
+          Someone may suggest this way. */
+       setStyleSheet("background: transparent");
+       #endif
+    }
+    else
+    {
+       /* The view fills the background itself with one opaque brush, so the
+          viewport needs neither clearing nor blending before each paint. */
+       viewport()->setAttribute(Qt::WA_OpaquePaintEvent);
+       viewport()->setAttribute(Qt::WA_NoSystemBackground);
+       setBackgroundBrush(viewport()->palette().brush(QPalette::Base));
+    }
+
+    /* The tile compositor overwrites the viewport with opaque pixels, see SW_TILE_COMPOSITOR. */
+    if (testOption(SW_TILE_COMPOSITOR) && testOption(SW_TRANSPARENT_FRAME))
+    {
+       #ifdef DEBUG
+       qDebug("%s : %s(%d) - The tile compositor needs an opaque window, use the scene.", __FILE__, __FUNCTION__, __LINE__);
+       #endif
+
+       m_nOptions &= ~SW_TILE_COMPOSITOR;
+    }
+
+    /* To set the scene(canvas) */
+    setScene(&m_scene);
+
+    /* The slides lie on one horizontal line and only the few around the view
+       are in the scene, see updateVisibleSlides(). Finding them is a division
+       of the scroll offset, so a BSP tree would only cost its rebuilds. */
+    m_scene.setItemIndexMethod(QGraphicsScene::NoIndex);
+
+    /* To let Horizontal/Vertical scrollbar be invisible always. */
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+
+    /* Add QGraphicsView object into FlickCharm. */
+    if (!testOption(SW_CONTROL_PANEL))
+       m_flickcharm.activateOn(this);
+
+    /* Set the window size from the configuration file or the screen. */
+    setFixedSize(loadLayout());
+    setRenderProfile(m_renderProfile);
+
+    /* To set the UI Designer created form instance to a QWidget instance. */
+    if (testOption(SW_CONTROL_PANEL))
+    {
+       QWidget *toolWidget = new QWidget(this);
+
+       m_slideControl.setupUi(toolWidget);
+       toolWidget->setWindowFlags(Qt::Tool);
+       toolWidget->move(QPoint(CTRL_PANEL_POS_X, CTRL_PANEL_POS_Y));
+       toolWidget->show();
+
+       /* Connect the buttons' event handler. */
+       QObject::connect(m_slideControl.pushButtonLeft, SIGNAL(clicked()), this, SLOT(slideLeft()));
+       QObject::connect(m_slideControl.pushButtonRight, SIGNAL(clicked()), this, SLOT(slideRight()));
+       QObject::connect(m_slideControl.pushButtonClose, SIGNAL(clicked()), QApplication::instance(), SLOT(quit()));
+    }
+
+    /* The timeline only measures the progress, the easing is m_motion's, see slideBy().
+       It also animates goToSlide() when flicking. */
+    m_timelineItem.setCurveShape(QTimeLine::LinearCurve);
+
+    /* Set animation timeline's "new-frame" event handler */
+    QObject::connect(&m_timelineItem, SIGNAL(valueChanged(qreal)), this, SLOT(stepSlide(qreal)));
+
+    /* Set timeline's "finished" event handler */
+    QObject::connect(&m_timelineItem, SIGNAL(finished()), this, SLOT(moveItemFinish()));
+
+    /* Set the duration of animation. */
+    m_timelineItem.setDuration(m_nAnimationDuration);
+    m_timelineItem.stop();
+
+    /* One overlay item draws the page numbers of all pictures. */
+    if (testOption(SW_PAGE_NUM))
+    {
+       m_pageNumItem = new PageNumberItem();
+       m_pageNumItem->setZValue(1); // Let it be the layer above the pixmap item.
+       m_scene.addItem(m_pageNumItem);
+    }
+
+    /* The pictures are decoded off the GUI thread, nearest to the view first. */
+    QObject::connect(&m_slideLoader, SIGNAL(slideLoaded(int, QImage, QByteArray, QImage)), this, SLOT(slideLoaded(int, QImage, QByteArray, QImage)));
+    QObject::connect(&m_slideLoader, SIGNAL(slideCancelled(int, QByteArray)), this, SLOT(slideCancelled(int, QByteArray)));
+
+    /* The thumbnail strip is a child of the view, not of the viewport, so scrolling does not move it. */
+    if (testOption(SW_THUMB_SCRUBBER))
+    {
+       m_scrubber = new ScrubberBar(this);
+       QObject::connect(m_scrubber, SIGNAL(slideScrubbed(int)), this, SLOT(slideScrubbed(int)));
+       QObject::connect(m_scrubber, SIGNAL(scrubFinished(int)), this, SLOT(scrubFinished(int)));
+    }
+
+    /* The zoomed picture covers the viewport, it is opened by the wheel or a pinch on a slide. */
+    if (testOption(SW_DEEP_ZOOM))
+    {
+       m_deepZoom = new DeepZoomView(m_tileCacheDir, m_nTileDiskMBytes, m_nTileBufferKBytes, this);
+       m_deepZoom->setMaxKBytes(m_nTileCacheKBytes);
+       QObject::connect(m_deepZoom, SIGNAL(closed()), this, SLOT(deepZoomClosed()));
+       viewport()->grabGesture(Qt::PinchGesture);
+    }
+
+    /* Add all images under the image folder, or of the slide bundle, see loadLayout(). */
+    addImages();
+    m_layoutSize = size();
+    m_scene.setSceneRect(0, 0, m_slideItems.count() * width(), height());
+    placeScrubber();
+
+    centerOn(width() / 2, height() / 2);
+    updateVisibleSlides();
+    scheduleSlides();
+
+    /* Move the first image. */
+    if (testOption(SW_CONTROL_PANEL))
+       slideBy(0);
+
+    /* Shed the caches when the device runs short of memory, regrow them after. */
+    QObject::connect(&m_memoryMonitor, SIGNAL(pressureChanged(int)), this, SLOT(memoryPressureChanged(int)));
+    m_memoryMonitor.start(m_nMemPollInterval);
+}
+
+/*! \fn SlidingWindow::~SlidingWindow()
+    \brief Destructor
+
+    The pictures out of the scene are not owned by it.
+ */
+SlidingWindow::~SlidingWindow()
+{
+    qDeleteAll(m_slideItems);
+}
+
+/*! \fn bool SlidingWindow::testOption(SlidingWindowOption option) const
+    \brief Check if a feature of the sliding window is switched on.
+
+    \param[in] option the feature to check.
+    \return true if the feature is switched on.
+ */
+bool SlidingWindow::testOption(SlidingWindowOption option) const
+{
+    return (m_nOptions & option) != 0;
+}
+
+/*! \fn void SlidingWindow::setRenderProfile(RenderProfile profile)
+    \brief Tune the view for power or quality, see RenderProfile.
+
+    \param[in] profile the rendering profile.
+    \return NONE.
+ */
+void SlidingWindow::setRenderProfile(RenderProfile profile)
+{
+    m_renderProfile = profile;
+
+    applyRenderProfile(this, profile);
+
+    m_frameStats.clear();
+}
+
+/*! \fn RenderProfile SlidingWindow::renderProfile() const
+    \brief Return the rendering profile of the view.
+
+    \param[in] NONE.
+    \return the rendering profile.
+ */
+RenderProfile SlidingWindow::renderProfile() const
+{
+    return m_renderProfile;
+}
+
+/*! \fn QString SlidingWindow::renderProfileName(RenderProfile profile)
+    \brief Return the name of a rendering profile, as "Render/Profile" of the layout file gives it.
+
+    \param[in] profile the rendering profile.
+    \return "default", "lowpower" or "quality".
+ */
+QString SlidingWindow::renderProfileName(RenderProfile profile)
+{
+    switch (profile)
+    {
+    case RENDER_LOW_POWER:
+       return "lowpower";
+    case RENDER_QUALITY:
+       return "quality";
+    default:
+       return "default";
+    }
+}
+
+/*! \fn RenderProfile SlidingWindow::renderProfileFromName(const QString &name, bool *ok)
+    \brief Return the rendering profile of a name, see renderProfileName().
+
+    \param[in] name the name of the profile.
+    \param[out] ok false if the name is unknown, the default profile is returned then.
+    \return the rendering profile.
+ */
+RenderProfile SlidingWindow::renderProfileFromName(const QString &name, bool *ok)
+{
+    RenderProfile profile = RENDER_DEFAULT;
+
+    if (name == "lowpower")
+       profile = RENDER_LOW_POWER;
+    else if (name == "quality")
+       profile = RENDER_QUALITY;
+
+    if (ok != NULL)
+       *ok = (profile != RENDER_DEFAULT || name == "default");
+
+    return profile;
+}
+
+/*! \fn void SlidingWindow::paintEvent(QPaintEvent *event)
+    \brief Paint the view, measuring the painting time when "ReportFrameTime" is set or a benchmark runs.
+
+    \param[in] QPaintEvent object.
+    \return NONE.
+ */
+void SlidingWindow::paintEvent(QPaintEvent *event)
+{
+    bool benchmarking = (m_nBenchStep > 0);
+    if (!m_bReportFrameTime && !benchmarking)
+    {
+       paintSlides(event);
+       return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    paintSlides(event);
+
+    qint64 elapsed = timer.nsecsElapsed();
+    if (benchmarking)
+       m_benchStats.addFrame(elapsed);
+
+    if (!m_bReportFrameTime)
+       return;
+
+    m_frameStats.addFrame(elapsed);
+    if (m_frameStats.frames() == FRAME_TIME_REPORT_FRAMES)
+    {
+       qDebug("Render profile %s : %s", qPrintable(renderProfileName(m_renderProfile)), qPrintable(m_frameStats.summary()));
+       m_frameStats.clear();
+    }
+}
+
+/*! \fn void SlidingWindow::paintSlides(QPaintEvent *event)
+    \brief Paint the view through the scene, or through the tile compositor with SW_TILE_COMPOSITOR.
+
+    \param[in] QPaintEvent object.
+    \return NONE.
+ */
+void SlidingWindow::paintSlides(QPaintEvent *event)
+{
+    if (testOption(SW_TILE_COMPOSITOR))
+       compositeSlides(event->rect());
+    else
+       QGraphicsView::paintEvent(event);
+}
+
+/*! \fn const QImage &SlidingWindow::slideTile(int index)
+    \brief Return the tile of a picture: the picture and its page number on an
+           opaque, window-sized RGB32 image, as the scene shows them.
+
+    \param[in] index the index of the picture.
+    \return the tile.
+ */
+const QImage &SlidingWindow::slideTile(int index)
+{
+    QImage &tile = m_slideTiles[index];
+
+    if (tile.isNull())
+    {
+       QGraphicsPixmapItem *slide = m_slideItems[index];
+       int posX = qMax(0, (width() - m_slideSizes[index].width()) / 2);
+
+       tile = QImage(width(), viewport()->height(), QImage::Format_RGB32);
+       tile.fill(viewport()->palette().color(QPalette::Base).rgb());
+
+       /* A placeholder thumbnail is stretched to the slide size. */
+       QPainter painter(&tile);
+       painter.setRenderHint(QPainter::SmoothPixmapTransform);
+       painter.drawPixmap(QRect(QPoint(posX, static_cast<int>(slide->pos().y())), m_slideSizes[index]), slide->pixmap());
+
+       if (m_pageNumItem != NULL)
+       {
+          painter.translate(-index * width(), 0);
+          m_pageNumItem->drawLabel(&painter, index);
+       }
+    }
+
+    return tile;
+}
+
+/*! \fn void SlidingWindow::compositeSlides(const QRect &exposed)
+    \brief Blit the tiles under the view straight into the viewport.
+
+    At most two tiles are under the view, the picture N covers [N*width, (N+1)*width)
+    of the slide strip, so the exposed area is one or two unscaled blits of
+    tile rows, without walking the scene nor an intermediate frame.
+
+    \param[in] exposed the rectangle of the viewport to paint.
+    \return NONE.
+ */
+void SlidingWindow::compositeSlides(const QRect &exposed)
+{
+    QRect area = exposed & viewport()->rect();
+    if (area.isEmpty() || width() <= 0)
+       return;
+
+    /* The left edge of the view on the slide strip. */
+    int viewX = qRound(mapToScene(0, 0).x()) - m_nStripOffset;
+    int first = qFloor(static_cast<qreal>(viewX) / width());
+    int shift = viewX - first * width();
+
+    QPainter painter(viewport());
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+
+    for (int n = 0; n < 2; n++)
+    {
+       /* The columns of the viewport covered by this tile, clipped to the exposed area. */
+       int index = first + n;
+       int viewLeft = (n == 0) ? 0 : width() - shift;
+       int tileX = (n == 0) ? shift : 0;
+       QRect target = QRect(viewLeft, area.top(), width() - tileX, area.height()) & area;
+
+       if (target.isEmpty())
+          continue;
+
+       if (index >= 0 && index < m_slideItems.count())
+          painter.drawImage(target.topLeft(), slideTile(index), target.translated(tileX - viewLeft, 0));
+       else
+          painter.fillRect(target, viewport()->palette().color(QPalette::Base));
+    }
+}
+
+/*! \fn QSize SlidingWindow::loadLayout()
+    \brief Load the window geometry and slide layout of this device.
+
+    The size comes from the configuration file when it has one, from the
+    screen when "FitScreen" is set, and from the built-in default otherwise.
+
+    \param[in] NONE.
+    \return the window size.
+ */
+QSize SlidingWindow::loadLayout()
+{
+    QSettings settings(DFLT_CONFIG_FILE, QSettings::IniFormat);
+    QSize winSize(settings.value("Window/Width", (int)MAIN_WIN_WIDTH).toInt(),
+                  settings.value("Window/Height", (int)MAIN_WIN_HEIGHT).toInt());
+
+    /* Set the window size fitting the dimension of the screen, e.g. for real device. */
+    if (settings.value("Window/FitScreen", false).toBool())
+       winSize = QApplication::desktop()->screenGeometry().size();
+
+    if (winSize.isEmpty())
+       winSize = QSize((int)MAIN_WIN_WIDTH, (int)MAIN_WIN_HEIGHT);
+
+    m_nAnimationDuration = settings.value("Layout/AnimationDuration", (int)ANIMATION_DURATION).toInt();
+    m_imageDir = settings.value("Layout/Images", DFLT_IMG_DIR).toString();
+
+    /* The slides within the resident radius keep their pixmaps, the compressed
+       tier keeps the ones released within its budget. */
+    m_nResidentRadius = qMax((int)SLIDE_LOAD_RADIUS, settings.value("Cache/ResidentRadius", (int)SLIDE_KEEP_RADIUS).toInt());
+    m_nCacheKBytes = settings.value("Cache/CompressedKB", (int)DFLT_SLIDE_CACHE_KBYTES).toInt();
+    m_bReportCacheHits = settings.value("Cache/ReportHitRate", false).toBool();
+    m_nKeepRadius = m_nResidentRadius;
+    m_slideCache.setMaxKBytes(m_nCacheKBytes);
+
+    /* The available memory below which the caches shrink, 0 interval to never check. */
+    m_memoryMonitor.setThresholds(settings.value("Memory/LowKB", (int)DFLT_MEM_LOW_KBYTES).toInt(),
+                                  settings.value("Memory/CriticalKB", (int)DFLT_MEM_CRITICAL_KBYTES).toInt());
+    m_nMemPollInterval = settings.value("Memory/PollInterval", (int)DFLT_MEM_POLL_INTERVAL).toInt();
+
+    /* Where the tile pyramids are cached, by default where the platform keeps the caches of applications. */
+    m_tileCacheDir = settings.value("DeepZoom/CacheDir").toString();
+    if (m_tileCacheDir.isEmpty())
+    {
+       #if QT_VERSION >= 0x050000
+       QString cacheLocation = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+       #else
+       QString cacheLocation = QDesktopServices::storageLocation(QDesktopServices::CacheLocation);
+       #endif
+
+       if (cacheLocation.isEmpty())
+          cacheLocation = QDir::tempPath() + "/" + QApplication::applicationName();
+
+       m_tileCacheDir = cacheLocation + "/" TILE_CACHE_FOLDER;
+    }
+
+    /* The disk space of the pyramids, and the memory for their tiles. */
+    m_nTileDiskMBytes = settings.value("DeepZoom/CacheMB", (int)DFLT_TILE_DISK_MBYTES).toInt();
+    m_nTileCacheKBytes = settings.value("DeepZoom/TileCacheKB", (int)DFLT_TILE_CACHE_KBYTES).toInt();
+    m_nTileBufferKBytes = settings.value("DeepZoom/BuildBufferKB", (int)DFLT_TILE_BUFFER_KBYTES).toInt();
+
+    /* The rendering profile, and whether to measure it. */
+    m_renderProfile = renderProfileFromName(settings.value("Render/Profile", DFLT_RENDER_PROFILE).toString());
+
+    m_bReportFrameTime = settings.value("Render/ReportFrameTime", false).toBool();
+
+    #ifdef DEBUG
+    qDebug("%s : %s(%d) - window = %dx%d, animation = %d ms", __FILE__, __FUNCTION__, __LINE__,
+           winSize.width(), winSize.height(), m_nAnimationDuration);
+    #endif
+
+    return winSize;
+}
+
+/*! \fn void SlidingWindow::resizeEvent(QResizeEvent *event)
+    \brief Lay the slides out again when the window size changes.
+
+    \param[in] QResizeEvent object.
+    \return NONE.
+ */
+void SlidingWindow::resizeEvent(QResizeEvent *event)
+{
+    QGraphicsView::resizeEvent(event);
+
+    if (event->size() == m_layoutSize || m_layoutSize.isEmpty())
+       return;
+
+    /* The zoomed picture started from a slide of the old size. */
+    if (m_deepZoom != NULL)
+       m_deepZoom->zoomOut();
+
+    /* Keep showing the same slide. */
+    int nCurrentSlide = testOption(SW_CONTROL_PANEL) ? -m_nNewPosOfFirstItem / m_layoutSize.width()
+                                                     : horizontalScrollBar()->value() / m_layoutSize.width();
+
+    /* Drop the slides scaled for the old size and scale them for the new one. */
+    qDeleteAll(m_slideItems);
+    m_slideItems.clear();
+    m_nFirstInScene = m_nLastInScene = -1;
+    m_slideTiles.clear();
+    m_slideLoader.clear();
+    m_slideFiles.clear();
+    m_slideSizes.clear();
+    m_loadedSlides.clear();
+    m_placeholderSlides.clear();
+    m_slideCache.clear();
+    m_packedSlides.clear();
+    if (m_pageNumItem != NULL)
+       m_pageNumItem->clearLabels();
+
+    addImages();
+    m_layoutSize = event->size();
+    m_scene.setSceneRect(0, 0, m_slideItems.count() * width(), height());
+    placeScrubber();
+
+    if (testOption(SW_CONTROL_PANEL))
+    {
+       m_timelineItem.stop();
+       m_nNewPosOfFirstItem = -nCurrentSlide * width();
+       moveItem(m_nNewPosOfFirstItem);
+    }
+    else
+    {
+       horizontalScrollBar()->setValue(nCurrentSlide * width());
+       updateVisibleSlides();
+       scheduleSlides();
+    }
+}
+
+/*! \fn void SlidingWindow::scrollContentsBy(int dx, int dy)
+    \brief Bring the pictures scrolled into the view into the scene, and decode the ones it is heading to.
+
+    \param[in] dx the horizontal scrolled distance.
+    \param[in] dy the vertical scrolled distance.
+    \return NONE.
+ */
+void SlidingWindow::scrollContentsBy(int dx, int dy)
+{
+    QGraphicsView::scrollContentsBy(dx, dy);
+
+    /* FlickCharm scrolls once per tick, so the distance is the speed of the flick.
+       A jump is no flick, the view is not heading anywhere. */
+    m_nScrollSpeed = m_bJumping ? 0 : -dx;
+
+    updateVisibleSlides();
+    scheduleSlides();
+}
+
+/*! \fn void SlidingWindow::placeSlide(int index)
+    \brief Put a picture item at its place on the slide strip, centered when narrower than the window.
+
+    \param[in] index the index of the picture.
+    \return NONE.
+ */
+void SlidingWindow::placeSlide(int index)
+{
+    QGraphicsPixmapItem *slide = m_slideItems[index];
+    int posX = qMax(0, (width() - m_slideSizes[index].width()) / 2);
+
+    slide->setPos(m_nStripOffset + index * width() + posX, slide->pos().y());
+}
+
+/*! \fn void SlidingWindow::updateVisibleSlides()
+    \brief Keep only the pictures under the view, and VISIBLE_SLIDE_MARGIN on each side, in the scene.
+
+    Picture N covers [N*width, (N+1)*width) of the slide strip, so the pictures
+    under the view follow from the scroll offset without asking the scene.
+
+    \param[in] NONE.
+    \return NONE.
+ */
+void SlidingWindow::updateVisibleSlides()
+{
+    int first = -1, last = -1;
+
+    if (!m_slideItems.isEmpty() && width() > 0)
+    {
+       /* The left edge of the view on the slide strip. */
+       int viewX = qRound(mapToScene(0, 0).x()) - m_nStripOffset;
+
+       first = qBound(0, qFloor(static_cast<qreal>(viewX) / width()) - VISIBLE_SLIDE_MARGIN, m_slideItems.count() - 1);
+       last = qBound(0, qFloor(static_cast<qreal>(viewX + width() - 1) / width()) + VISIBLE_SLIDE_MARGIN, m_slideItems.count() - 1);
+    }
+
+    if (first == m_nFirstInScene && last == m_nLastInScene)
+       return;
+
+    /* Take the pictures leaving the view out of the scene ... */
+    for (int i = m_nFirstInScene; i >= 0 && i <= m_nLastInScene; i++)
+    {
+       if (i < first || i > last)
+       {
+          m_scene.removeItem(m_slideItems[i]);
+          m_slideTiles.remove(i);
+       }
+    }
+
+    /* ... and put the ones coming into it. */
+    for (int i = first; i >= 0 && i <= last; i++)
+    {
+       if (i < m_nFirstInScene || i > m_nLastInScene)
+       {
+          placeSlide(i);
+          m_scene.addItem(m_slideItems[i]);
+       }
+    }
+
+    m_nFirstInScene = first;
+    m_nLastInScene = last;
+}
+
+/*! \fn void SlidingWindow::scheduleSlides()
+    \brief Decode the pictures around the view and where it is heading, and release the far ones.
+
+    \param[in] NONE.
+    \return NONE.
+ */
+void SlidingWindow::scheduleSlides()
+{
+    if (m_slideItems.isEmpty() || width() <= 0)
+       return;
+
+    /* The left edge of the view on the slide strip, and where it stops. */
+    int viewX = qRound(mapToScene(0, 0).x()) - m_nStripOffset;
+    int headingX = 0;
+
+    if (testOption(SW_CONTROL_PANEL))
+       headingX = -m_nNewPosOfFirstItem;  /* The end of the running animation. */
+    else
+       /* FlickCharm slows a flick down by 1 pixel per tick, so it stops speed*(speed+1)/2 pixels farther. */
+       headingX = viewX + m_nScrollSpeed * (qAbs(m_nScrollSpeed) + 1) / 2;
+
+    int last = m_slideItems.count() - 1;
+    int current = qBound(0, qFloor((viewX + width() / 2.0) / width()), last);
+    int predicted = qBound(0, qFloor((headingX + width() / 2.0) / width()), last);
+
+    if (m_scrubber != NULL)
+       m_scrubber->setCurrent(current);
+
+    /* Reorder the pending jobs, and cancel the ones for slides the view has passed. */
+    m_slideLoader.setFocus(current, predicted);
+
+    /* Release the pictures and placeholders left behind ... */
+    foreach (int index, m_loadedSlides + m_placeholderSlides)
+    {
+       if (qMin(qAbs(index - current), qAbs(index - predicted)) > m_nKeepRadius)
+       {
+          m_slideItems[index]->setPixmap(QPixmap());
+          m_slideItems[index]->setTransform(QTransform());
+          m_slideTiles.remove(index);
+          m_loadedSlides.remove(index);
+          m_placeholderSlides.remove(index);
+
+          /* Only now the picture counts against the budget of the compressed tier. */
+          m_slideCache.insert(index, m_packedSlides.take(index));
+       }
+    }
+
+    /* While the thumbnail strip is dragged the view cuts through the slides, nothing is decoded. */
+    if (m_bScrubbing)
+    {
+       if (!m_loadedSlides.contains(current) && !m_placeholderSlides.contains(current))
+          showThumbnail(current, m_scrubber->thumbnail(current));
+       return;
+    }
+
+    /* ... and decode the ones near the view, the loader orders them. */
+    for (int i = qMax(0, qMin(current, predicted) - SLIDE_LOAD_RADIUS);
+         i <= qMin(last, qMax(current, predicted) + SLIDE_LOAD_RADIUS); i++)
+    {
+       if (qMin(qAbs(i - current), qAbs(i - predicted)) <= SLIDE_LOAD_RADIUS &&
+           !m_loadedSlides.contains(i) && !m_slideLoader.isRequested(i))
+       {
+          if (m_bundle.isOpen())
+          {
+             /* Nothing to decode, the picture is copied from the mapping into the pixmap. */
+             slideLoaded(i, m_bundle.slide(i));
+          }
+          else
+          {
+             requestSlide(i);
+          }
+       }
+    }
+}
+
+/*! \fn void SlidingWindow::requestSlide(int index)
+    \brief Queue a picture to the slide loader, from the compressed tier when it is there.
+
+    \param[in] index the index of the picture.
+    \return NONE.
+ */
+void SlidingWindow::requestSlide(int index)
+{
+    QByteArray packed;
+
+    /* The decoder scales the thumbnail of the strip too, off the GUI thread. */
+    QSize thumbSize;
+    if (m_scrubber != NULL && !m_scrubber->hasThumbnail(index))
+       thumbSize = m_scrubber->thumbnailSize();
+
+    /* Inflating takes a few milliseconds, not worth a placeholder. */
+    if (m_slideCache.take(index, packed))
+       m_slideLoader.request(index, m_slideFiles[index], m_slideSizes[index], false, thumbSize, packed);
+    else
+    {
+       showPlaceholder(index);
+
+       /* Without a budget the packed picture would be dropped, so it is not compressed. */
+       m_slideLoader.request(index, m_slideFiles[index], m_slideSizes[index], m_slideCache.maxKBytes() > 0, thumbSize);
+    }
+
+    int lookups = m_slideCache.hits() + m_slideCache.misses();
+    if (m_bReportCacheHits && lookups % CACHE_REPORT_LOOKUPS == 0)
+    {
+       qDebug("Slide cache : %d lookups, hit rate %.1f%%, %d of %d KB", lookups,
+              100.0 * m_slideCache.hits() / lookups, m_slideCache.totalKBytes(), m_slideCache.maxKBytes());
+    }
+}
+
+/*! \fn void SlidingWindow::memoryPressureChanged(int pressure)
+    \brief Shrink the caches under memory pressure, cheapest to rebuild first, and regrow them when it eases.
+
+    Low pressure cuts the compressed tier to a share of its budget, releases
+    the pictures beyond the load radius and empties Qt's pixmap cache. Critical
+    pressure also drops the compressed tier and the compositor tiles of the
+    slides out of the scene, so only what is on screen or about to be stays.
+
+    \param[in] pressure the MemoryPressure level.
+    \return NONE.
+ */
+void SlidingWindow::memoryPressureChanged(int pressure)
+{
+    #ifdef DEBUG
+    qDebug("%s : %s(%d) - memory pressure %d, %lld KB available", __FILE__, __FUNCTION__, __LINE__,
+           pressure, m_memoryMonitor.availableKBytes());
+    #endif
+
+    switch (pressure)
+    {
+    case MEM_PRESSURE_NONE:
+       m_nKeepRadius = m_nResidentRadius;
+       m_slideCache.setMaxKBytes(m_nCacheKBytes);
+       if (m_deepZoom != NULL)
+          m_deepZoom->setMaxKBytes(m_nTileCacheKBytes);
+       break;
+
+    case MEM_PRESSURE_LOW:
+       m_nKeepRadius = SLIDE_LOAD_RADIUS;
+       m_slideCache.setMaxKBytes(m_nCacheKBytes / LOW_MEM_CACHE_SHARE);
+       if (m_deepZoom != NULL)
+          m_deepZoom->setMaxKBytes(m_nTileCacheKBytes / LOW_MEM_CACHE_SHARE);
+       QPixmapCache::clear();
+       break;
+
+    default:
+       m_nKeepRadius = SLIDE_LOAD_RADIUS;
+       m_slideCache.setMaxKBytes(0);
+       m_packedSlides.clear();
+       if (m_deepZoom != NULL)
+          m_deepZoom->setMaxKBytes(0);  /* A view of tiles is always kept. */
+       QPixmapCache::clear();
+
+       foreach (int index, m_slideTiles.keys())
+       {
+          if (index < m_nFirstInScene || index > m_nLastInScene)
+             m_slideTiles.remove(index);
+       }
+       break;
+    }
+
+    /* Release the pictures beyond the new radius now rather than on the next scroll. */
+    scheduleSlides();
+}
+
+/*! \fn void SlidingWindow::placeScrubber()
+    \brief Put the thumbnail strip over the bottom of the view, browsing the slides laid out.
+
+    \param[in] NONE.
+    \return NONE.
+ */
+void SlidingWindow::placeScrubber()
+{
+    if (m_scrubber == NULL)
+       return;
+
+    QRect area = viewport()->geometry();
+    m_scrubber->setGeometry(area.left(), area.bottom() - SCRUBBER_HEIGHT + 1, area.width(), SCRUBBER_HEIGHT);
+
+    /* The thumbnails do not depend on the window size, they are kept across a resize. */
+    if (m_bundle.isOpen())
+       m_scrubber->setBundle(m_imageDir, m_bundle.count());
+    else
+       m_scrubber->setFiles(m_slideFiles);
+
+    m_scrubber->raise();
+    m_scrubber->show();
+}
+
+/*! \fn void SlidingWindow::slideScrubbed(int index)
+    \brief Cut to the slide under the dragged thumbnail strip, it shows its thumbnail until the strip is released.
+
+    \param[in] index the index of the picture.
+    \return NONE.
+ */
+void SlidingWindow::slideScrubbed(int index)
+{
+    m_bScrubbing = true;
+    goToSlide(index, false);
+}
+
+/*! \fn void SlidingWindow::scrubFinished(int index)
+    \brief Slide to the picture the thumbnail strip was left on or clicked, and decode the pictures around it.
+
+    \param[in] index the index of the picture.
+    \return NONE.
+ */
+void SlidingWindow::scrubFinished(int index)
+{
+    m_bScrubbing = false;
+
+    /* After a drag the view is already there, only the decoding is left. */
+    goToSlide(index);
+    scheduleSlides();
+}
+
+/*! \fn void SlidingWindow::deepZoomClosed()
+    \brief Give the slides back the input and decode the ones released while the picture was zoomed.
+
+    \param[in] NONE.
+    \return NONE.
+ */
+void SlidingWindow::deepZoomClosed()
+{
+    setFocus();
+
+    /* Memory pressure may have released the slides around the view meanwhile. */
+    scheduleSlides();
+    viewport()->update();
+}
+
+/*! \fn bool SlidingWindow::openDeepZoom()
+    \brief Show the picture of the current slide at full resolution, if it was shrunk to the slide.
+
+    \param[in] NONE.
+    \return true if the zoomed picture is shown.
+ */
+bool SlidingWindow::openDeepZoom()
+{
+    if (m_deepZoom == NULL || m_slideItems.isEmpty() || width() <= 0)
+       return false;
+
+    if (m_deepZoom->isVisible())
+       return true;
+
+    /* Not in the middle of a slide, the picture would jump. */
+    if (m_timelineItem.state() == QTimeLine::Running)
+       return false;
+
+    int index = testOption(SW_CONTROL_PANEL) ? -m_nNewPosOfFirstItem / width()
+                                             : (horizontalScrollBar()->value() + width() / 2) / width();
+    index = qBound(0, index, m_slideItems.count() - 1);
+
+    QString fileName = m_slideFiles.value(index);
+    if (fileName.isEmpty() || !m_loadedSlides.contains(index))
+       return false;
+
+    /* Only a picture shrunk to its slide has more to show. */
+    QSize size = QImageReader(fileName).size();
+    if (ExifReader::isTransposed(ExifReader(fileName).orientation()))
+       size.transpose();
+
+    if (!size.isValid() || size.width() <= m_slideSizes[index].width())
+       return false;
+
+    m_flickcharm.stop(this);
+    m_deepZoom->setGeometry(viewport()->geometry());
+    m_deepZoom->open(fileName, m_slideItems[index]->pixmap().toImage(), size);
+
+    return true;
+}
+
+/*! \fn void SlidingWindow::wheelEvent(QWheelEvent *event)
+    \brief Zoom into the picture of the current slide with the wheel.
+
+    \param[in] QWheelEvent object.
+    \return NONE.
+ */
+void SlidingWindow::wheelEvent(QWheelEvent *event)
+{
+    if (event->delta() > 0 && openDeepZoom())
+    {
+       m_deepZoom->zoomBy(qPow(DEEP_ZOOM_WHEEL_STEP, event->delta() / 120.0), event->pos());
+       return;
+    }
 
-#ifdef ADD_PAGE_NUM
-#define PAGE_NUM_POS_OFFSET_X  50
-#define PAGE_NUM_POS_OFFSET_Y  30
-#endif
+    QGraphicsView::wheelEvent(event);
+}
 
-#define DEBUG   // To show debugging messages.
+/*! \fn bool SlidingWindow::viewportEvent(QEvent *event)
+    \brief Zoom into the picture of the current slide with a pinch on the viewport.
 
-/*! \fn SlidingWindow::SlidingWindow()
-    \brief Constructor
+    \param[in] QEvent object.
+    \return true if the event was handled.
  */
-SlidingWindow::SlidingWindow()
-    : QGraphicsView()
-    #ifdef USE_CONTROL_PANEL
-    , m_nNewPosOfFirstItem(0)
-    #endif
-    #ifndef USE_CONTROL_PANEL
-    , m_flickcharm(this, FLICK_HORIZONTAL)
-    #endif
-    #ifdef ADD_PAGE_NUM
-    , m_textItem(NULL)
-    #endif
+bool SlidingWindow::viewportEvent(QEvent *event)
 {
-    /* Set the view widget to be frameless. */
-    setWindowFlags(Qt::FramelessWindowHint);
+    if (event->type() == QEvent::Gesture && m_deepZoom != NULL)
+    {
+       QPinchGesture *pinch = static_cast<QPinchGesture*>(static_cast<QGestureEvent*>(event)->gesture(Qt::PinchGesture));
 
-#ifdef ENABLE_TRANSPARENT_FRAME
-    /* To set the scene's background to be transparent */
-    /* LOOK! In Linux, this will take effect only when
-        COMPIZ(compositing manager) turns on. */
-    /* When using this line, it must set WindowFlags "Qt::FramelessWindowHint" */
-    setAttribute(Qt::WA_TranslucentBackground);
-
-    /* There are three ways to achieve transparent window frame effect. */
-    #if 0
-    /* <Way - 1> */
-    viewport()->setAutoFillBackground(false);
-    #elif 1
-    /* <Way - 2>. */
-    QPalette p = viewport()->palette();
-    p.setColor(QPalette::Base, Qt::transparent);
-    viewport()->setPalette(p);
-    #elif 0
-    /* <Way - 3>
-       Someone may suggest this way. */
-    setStyleSheet("background: transparent");
-    #endif
-#endif /* ENABLE_TRANSPARENT_FRAME */
+       /* The pinch goes on to the viewport after the zoomed picture opened. */
+       if (pinch != NULL && (pinch->changeFlags() & QPinchGesture::ScaleFactorChanged) &&
+           (m_deepZoom->isVisible() || pinch->scaleFactor() > 1) && openDeepZoom())
+          m_deepZoom->zoomBy(pinch->scaleFactor(), viewport()->mapFromGlobal(pinch->centerPoint().toPoint()));
 
-    /* To set the scene(canvas) */
-    setScene(&m_scene);
+       return true;
+    }
 
-    /* To let Horizontal/Vertical scrollbar be invisible always. */
-    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    return QGraphicsView::viewportEvent(event);
+}
 
-    /* Add QGraphicsView object into FlickCharm. */
-    #ifndef USE_CONTROL_PANEL
-    m_flickcharm.activateOn(this);
-    #endif
+/*! \fn void SlidingWindow::showPlaceholder(int index)
+    \brief Show the EXIF thumbnail of a picture, stretched to its slide, until the picture is decoded.
 
-    #if 0 // These two lines are for real device.
-    /* Set the window size fitting the dimension of the screen. */
-    QRect screen_size = QApplication::desktop()->screenGeometry();
-    setFixedSize(screen_size.width(), screen_size.height());
-    #else  // This is for simulating on development environment.
-    /* Set the window size. */
-    setFixedSize((int)MAIN_WIN_WIDTH, (int)MAIN_WIN_HEIGHT);
-    #endif
+    \param[in] index the index of the picture.
+    \return NONE.
+ */
+void SlidingWindow::showPlaceholder(int index)
+{
+    if (m_placeholderSlides.contains(index))
+       return;
 
-    /* To set the UI Designer created form instance to a QWidget instance. */
-    #ifdef USE_CONTROL_PANEL
-    QWidget *toolWidget = new QWidget(this);
+    ExifReader exif(m_slideFiles[index]);
+    QImage thumbnail = exif.thumbnail();
 
-    m_slideControl.setupUi(toolWidget);
-    toolWidget->setWindowFlags(Qt::Tool);
-    toolWidget->move(QPoint(CTRL_PANEL_POS_X, CTRL_PANEL_POS_Y));
-    toolWidget->show();
+    if (thumbnail.isNull())
+       return;
 
-    /* Connect the buttons' event handler. */
-    QObject::connect(m_slideControl.pushButtonLeft, SIGNAL(clicked()), this, SLOT(slideLeft()));
-    QObject::connect(m_slideControl.pushButtonRight, SIGNAL(clicked()), this, SLOT(slideRight()));
-    QObject::connect(m_slideControl.pushButtonClose, SIGNAL(clicked()), QApplication::instance(), SLOT(quit()));
+    showThumbnail(index, thumbnail.transformed(ExifReader::orientationTransform(exif.orientation())));
+}
 
-    /* Set animation timeline's easing curve. Using Linear easing curve. */
-    m_timelineItem.setCurveShape(QTimeLine::LinearCurve);
+/*! \fn void SlidingWindow::showThumbnail(int index, const QImage &thumbnail)
+    \brief Show an upright thumbnail of a picture stretched to its slide, until the picture is decoded.
 
-    /* Set animation timeline's "new-frame" event handler */
-    QObject::connect(&m_timelineItem, SIGNAL(frameChanged(int)), this, SLOT(moveItem(int)));
+    \param[in] index the index of the picture.
+    \param[in] thumbnail the thumbnail, nothing is shown if it is null.
+    \return NONE.
+ */
+void SlidingWindow::showThumbnail(int index, const QImage &thumbnail)
+{
+    if (thumbnail.isNull() || m_slideSizes[index].isEmpty())
+       return;
 
-    /* Set timeline's "finished" event handler */
-    QObject::connect(&m_timelineItem, SIGNAL(finished()), this, SLOT(moveItemFinish()));
+    /* The item scales the thumbnail when painting, no slide-sized pixmap is made for it. */
+    QGraphicsPixmapItem *slide = m_slideItems[index];
+    slide->setPixmap(QPixmap::fromImage(thumbnail));
+    slide->setTransformationMode(Qt::SmoothTransformation);
+    slide->setTransform(QTransform::fromScale(static_cast<qreal>(m_slideSizes[index].width()) / thumbnail.width(),
+                                              static_cast<qreal>(m_slideSizes[index].height()) / thumbnail.height()));
 
-    /* Set the duration of animation. */
-    m_timelineItem.setDuration((int)ANIMATION_DURATION);
-    m_timelineItem.stop();
-    #endif
+    m_placeholderSlides.insert(index);
+    m_slideTiles.remove(index);
+}
 
-    /* Reset QString content. */
-    m_imageDir.clear();
-    m_imageDir.append(DFLT_IMG_DIR);
+/*! \fn void SlidingWindow::slideLoaded(int index, const QImage &image, const QByteArray &packed, const QImage &thumbnail)
+    \brief Show a picture decoded by the slide loader.
 
-    /* Add all images under the image folder. */
-    addImages();
+    \param[in] index the index of the picture.
+    \param[in] image the picture scaled to its slide size, null if it could not be decoded.
+    \param[in] packed the picture for the compressed tier, empty if the tier has no budget.
+    \param[in] thumbnail the thumbnail of the picture for the scrubber bar, null if it has one.
+    \return NONE.
+ */
+void SlidingWindow::slideLoaded(int index, const QImage &image, const QByteArray &packed, const QImage &thumbnail)
+{
+    if (index < 0 || index >= m_slideItems.count())
+       return;
 
-    centerOn(width() / 2, height() / 2);
+    /* Kept aside while the picture is shown, see scheduleSlides(). */
+    if (!packed.isEmpty())
+       m_packedSlides.insert(index, packed);
+
+    /* The strip gets the thumbnail of a decoded picture without reading its file. */
+    if (m_scrubber != NULL)
+       m_scrubber->addThumbnail(index, thumbnail);
+
+    /* A picture failing to decode is not requested again, it stays empty. */
+    QGraphicsPixmapItem *slide = m_slideItems[index];
+    slide->setPixmap(QPixmap::fromImage(image));
+    slide->setTransform(QTransform());
+    slide->setTransformationMode(Qt::FastTransformation);
+    m_loadedSlides.insert(index);
+    m_placeholderSlides.remove(index);
+
+    /* The tile was drawn without the picture. */
+    m_slideTiles.remove(index);
+    if (testOption(SW_TILE_COMPOSITOR))
+       viewport()->update();
+}
 
-    /* Move the first image. */
-    #ifdef USE_CONTROL_PANEL
-    slideBy(0);
-    #endif
+/*! \fn void SlidingWindow::slideCancelled(int index, const QByteArray &packed)
+    \brief Put back a packed slide requestSlide() took out of the compressed tier, its job was cancelled.
+
+    \param[in] index the index of the picture.
+    \param[in] packed the picture packed by SlideCache.
+    \return NONE.
+ */
+void SlidingWindow::slideCancelled(int index, const QByteArray &packed)
+{
+    m_slideCache.insert(index, packed);
 }
 
 /*! \fn void SlidingWindow::addImages()
@@ -153,11 +1204,14 @@ SlidingWindow::SlidingWindow()
  */
 void SlidingWindow::addImages()
 {
+    /* A slide bundle holds the pictures ready to show. */
+    if (QFileInfo(m_imageDir).isFile())
+    {
+       addBundle();
+       return;
+    }
+
     QDir imgDir(m_imageDir); // Create a QDir instance representing the directory containing images.
-    #ifdef ADD_PAGE_NUM
-    QPen pen;  // Create a Pen object for draw page number of each picture.
-    QBrush brush(Qt::SolidPattern);
-    #endif
 
     /* To examinate if the image folder is existent. */
     if(imgDir.exists() == false)
@@ -192,41 +1246,41 @@ void SlidingWindow::addImages()
     /* Set filter for displaying Files only */
     imgDir.setFilter(QDir::Files);
 
-    /* Configure the Pen object. */
-    #ifdef ADD_PAGE_NUM
-    pen.setWidth(2);
-    pen.setColor(QColor(105, 158, 0, 255)); // R, G, B, Alpha
-    pen.setStyle(Qt::SolidLine);
-    pen.setCapStyle(Qt::RoundCap);
-    pen.setJoinStyle(Qt::RoundJoin);
-    #endif
+    if (m_pageNumItem != NULL)
+       m_pageNumItem->setSlideWidth(width());
 
     /* To iterate all images under the created the directory and add them into  */
     QStringList imgFileList = imgDir.entryList();
     for(int i = 0; i < imgFileList.count(); i++)
     {
-        /* Create a Pixmap*/
+        /* Read the size of the image only, it is decoded when it gets near the view, see scheduleSlides(). */
         /* Changed for Qt5, 2015-09-10 */
         #if QT_VERSION < 0x050000
-        QPixmap pixmap( QString("%1/%2").arg(m_imageDir).arg(((QString)imgFileList.at(i)).toAscii().data()) ) ; /* 1st, 2nd argement assignment to form a string. */
+        QString fileName( QString("%1/%2").arg(m_imageDir).arg(((QString)imgFileList.at(i)).toAscii().data()) ) ; /* 1st, 2nd argement assignment to form a string. */
         #else
-        QPixmap pixmap( QString("%1/%2").arg(m_imageDir).arg(((QString)imgFileList.at(i)).toStdString().c_str()) ) ; /* 1st, 2nd argement assignment to form a string. */
+        QString fileName( QString("%1/%2").arg(m_imageDir).arg(((QString)imgFileList.at(i)).toStdString().c_str()) ) ; /* 1st, 2nd argement assignment to form a string. */
         #endif
+        QSize imageSize = QImageReader(fileName).size();
 
-        /* Declare a QGraphicsPixmapItem pointer */
+        /* Lay the picture out upright, see SlideDecoder::run(). */
+        if (ExifReader::isTransposed(ExifReader(fileName).orientation()))
+           imageSize.transpose();
+
+        /* Declare a QGraphicsPixmapItem pointer, and the size of its picture once scaled. */
         QGraphicsPixmapItem *imageItem = NULL;
+        QSize slideSize;
 
         /* Scale the new created image item to fit the dimension of the screen. */
-        int diffScreenWidth = pixmap.width() - width();
-        int diffScreenHeight = pixmap.height() - height();
+        int diffScreenWidth = imageSize.width() - width();
+        int diffScreenHeight = imageSize.height() - height();
         qreal scaleRatio = 1.0;
         int newHeight = 0, newWidth = 0;
 
         /* If the width of pixmap is greater than screen width. */
         if(diffScreenWidth > 0)
         {
-           scaleRatio =  static_cast<qreal>(width()) / static_cast<qreal>(pixmap.width());
-           newWidth = static_cast<int>(pixmap.width() * scaleRatio);
+           scaleRatio =  static_cast<qreal>(width()) / static_cast<qreal>(imageSize.width());
+           newWidth = static_cast<int>(imageSize.width() * scaleRatio);
 
            /* If the calculated width is exactly the same as screen width minus one,
               just assign the screen width to the new width. */
@@ -236,15 +1290,15 @@ void SlidingWindow::addImages()
            #ifdef DEBUG
            qDebug("%s : %s(%d) - Item(%d) WIDTH(%d) : screenWidth = %d, diffScreenWidth = %d , scaleRatio=%f, newWidth = %d",
                   __FILE__, __FUNCTION__, __LINE__, i,
-                  pixmap.width(), width(), diffScreenWidth, scaleRatio, newWidth);
+                  imageSize.width(), width(), diffScreenWidth, scaleRatio, newWidth);
            #endif
         }
 
         /* If the height of pixmap is greater than screen height. */
         if(diffScreenHeight > 0)
         {
-           scaleRatio =  static_cast<qreal>(height()) / static_cast<qreal>(pixmap.height());
-           newHeight = static_cast<int>(pixmap.height() * scaleRatio);
+           scaleRatio =  static_cast<qreal>(height()) / static_cast<qreal>(imageSize.height());
+           newHeight = static_cast<int>(imageSize.height() * scaleRatio);
 
            /* If the calculated height is exactly the same as screen height minus one,
               just assign the screen height to the new height. */
@@ -254,11 +1308,11 @@ void SlidingWindow::addImages()
            #ifdef DEBUG
            qDebug("%s : %s(%d) - Item(%d) HEIGHT(%d) : screenHeight = %d, diffScreenHeight = %d, scaleRatio=%f, newHeight = %d",
                   __FILE__, __FUNCTION__, __LINE__, i,
-                  pixmap.height(), height(), diffScreenHeight, scaleRatio, newHeight);
+                  imageSize.height(), height(), diffScreenHeight, scaleRatio, newHeight);
            #endif
         }
 
-        /* Create a graphic item from a Scaled Pixmap image. */
+        /* The size of a graphic item from a Scaled Pixmap image. */
         if(scaleRatio != 1.0)
         {
             if(newWidth != 0 && newHeight != 0)
@@ -267,7 +1321,7 @@ void SlidingWindow::addImages()
                 qDebug("%s : %s(%d)", __FILE__, __FUNCTION__, __LINE__);
                 #endif
 
-                imageItem = m_scene.addPixmap(pixmap.scaled( QSize(newWidth,newHeight) ));
+                slideSize = QSize(newWidth,newHeight);
             }
             else if(newWidth != 0)
             {
@@ -275,7 +1329,7 @@ void SlidingWindow::addImages()
                 qDebug("%s : %s(%d)", __FILE__, __FUNCTION__, __LINE__);
                 #endif
 
-                imageItem = m_scene.addPixmap(pixmap.scaled( QSize(newWidth,pixmap.height()) ));
+                slideSize = QSize(newWidth,imageSize.height());
             }
             else if(newHeight != 0)
             {
@@ -283,50 +1337,74 @@ void SlidingWindow::addImages()
                 qDebug("%s : %s(%d)", __FILE__, __FUNCTION__, __LINE__);
                 #endif
 
-                imageItem = m_scene.addPixmap(pixmap.scaled( QSize(pixmap.width(),newHeight) ));
+                slideSize = QSize(imageSize.width(),newHeight);
             }
-        } /* Create a graphic item from unscaled Pixmap image. */
+        } /* The size of a graphic item from unscaled Pixmap image. */
         else if(diffScreenWidth<=0 && diffScreenHeight<=0)
         {
             #ifdef DEBUG
             qDebug("%s : %s(%d)", __FILE__, __FUNCTION__, __LINE__);
             #endif
 
-            imageItem = m_scene.addPixmap(pixmap);
+            slideSize = imageSize;
         }
 
-        /* Create a QGraphicsSimpleTextItem pointer */
-        #ifdef ADD_PAGE_NUM
-        QString pageNo;
-
-        pageNo.sprintf ("P.%d", (i+1));
-        m_textItem = m_scene.addSimpleText(pageNo);
-        m_textItem->setPen(pen);
-        m_textItem->setBrush(brush);
-        m_textItem->setFont(QFont("Arial", 14)); // set the font of page number.
-        m_textItem->setZValue(1); // Let it be the layer above the pixmap item.
-
-        QFont textFont = m_textItem->font();
-        textFont.setPointSize(16); // set the font size of page number.
-        #endif
+        /* The item stays empty until its picture is decoded, see slideLoaded(). */
+        imageItem = new QGraphicsPixmapItem();
+        m_slideFiles += fileName;
+        m_slideSizes += slideSize;
 
         /* Set the position of pixmap graphic item on the scene. */
-        setImageItemPos(imageItem);
+        setImageItemPos(imageItem, slideSize);
 
-        #ifdef ADD_PAGE_NUM
         /* Set the position of NO. of pixmap graphic item on the scene. */
-        setImageItemNoPos(imageItem, m_textItem, imageItem->pos(), imageItem->pixmap());
-        #endif
+        if (m_pageNumItem != NULL)
+           setImageItemNoPos(imageItem, slideSize, i+1);
+    }
+}
+
+/*! \fn void SlidingWindow::addBundle()
+    \brief Add the image items of the slide bundle, laid out from its offset table.
+
+    \param[in] NONE.
+    \return NONE.
+ */
+void SlidingWindow::addBundle()
+{
+    if (!m_bundle.open(m_imageDir))
+       return;
+
+    /* The slides were scaled by the bundler, they are shown as they are. */
+    if (m_bundle.targetSize() != size())
+       qDebug("%s : %s(%d) - The slide bundle is made for %dx%d, the window is %dx%d.", __FILE__, __FUNCTION__, __LINE__,
+              m_bundle.targetSize().width(), m_bundle.targetSize().height(), width(), height());
+
+    if (m_pageNumItem != NULL)
+       m_pageNumItem->setSlideWidth(width());
+
+    for (int i = 0; i < m_bundle.count(); i++)
+    {
+        QGraphicsPixmapItem *imageItem = new QGraphicsPixmapItem();
+        QSize slideSize = m_bundle.slideSize(i);
+
+        m_slideFiles += QString();
+        m_slideSizes += slideSize;
+
+        setImageItemPos(imageItem, slideSize);
+
+        if (m_pageNumItem != NULL)
+           setImageItemNoPos(imageItem, slideSize, i+1);
     }
 }
 
-/*! \fn void SlidingWindow::setImageItemPos(QGraphicsPixmapItem* imgItem)
+/*! \fn void SlidingWindow::setImageItemPos(QGraphicsPixmapItem* imgItem, const QSize &size)
     \brief Set item's position
 
     \param[in] QGraphicsPixmapItem object.
+    \param[in] the size of its picture once decoded.
     \return NONE.
  */
-void SlidingWindow::setImageItemPos(QGraphicsPixmapItem* imgItem)
+void SlidingWindow::setImageItemPos(QGraphicsPixmapItem* imgItem, const QSize &size)
 {
    if(imgItem == NULL)
    {
@@ -335,13 +1413,12 @@ void SlidingWindow::setImageItemPos(QGraphicsPixmapItem* imgItem)
       return;
    }
 
-   QPixmap pixmap = imgItem->pixmap();
    int posX = 0.0, posY = 0.0;
    int diffWidth = 0, diffHeight = 0;
 
-   if(pixmap.width() < width())
+   if(size.width() < width())
    {
-       diffWidth = width() - pixmap.width();
+       diffWidth = width() - size.width();
        posX = diffWidth / 2;
 
        #ifdef DEBUG
@@ -349,9 +1426,9 @@ void SlidingWindow::setImageItemPos(QGraphicsPixmapItem* imgItem)
        #endif
    }
 
-   if(pixmap.height() < height())
+   if(size.height() < height())
    {
-      diffHeight = height() - pixmap.height();
+      diffHeight = height() - size.height();
       posY = diffHeight / 2 ;
 
       #ifdef DEBUG
@@ -359,13 +1436,13 @@ void SlidingWindow::setImageItemPos(QGraphicsPixmapItem* imgItem)
       #endif
    }
 
-   /* Add the new created graphic items to the scene */
-   imgItem->setPos(m_slideItems.count()*SLIDE_OFFSET+posX, 0+posY);
+   /* Place the new created graphic item on the slide strip, it joins the scene when it gets near the view. */
+   imgItem->setPos(m_slideItems.count()*width()+posX, 0+posY);
 
    #ifdef DEBUG
    qDebug("%s : %s() - pixWidth = %d, pixHeight = %d, posX = %d, posY = %d, sceneX = %f, sceneY = %f\n",
           __FILE__, __FUNCTION__,
-          pixmap.width(), pixmap.height(), posX, posY,
+          size.width(), size.height(), posX, posY,
           imgItem->scenePos().x(), imgItem->scenePos().y());
    #endif
 
@@ -373,41 +1450,32 @@ void SlidingWindow::setImageItemPos(QGraphicsPixmapItem* imgItem)
    m_slideItems += imgItem;
 }
 
-#ifdef ADD_PAGE_NUM
-/*! \fn void SlidingWindow::setImageItemNoPos(QGraphicsPixmapItem* imgItem, QGraphicsSimpleTextItem *imgItemNo, QPointF pos, QPixmap pixmap)
+/*! \fn void SlidingWindow::setImageItemNoPos(QGraphicsPixmapItem* imgItem, const QSize &size, int pageNo)
     \brief Add page number onto a image item.
 
     \param[in] QGraphicsPixmapItem object.
-    \param[in] QGraphicsSimpleTextItem object.
-    \param[in] QPointF object.
-    \param[in] QPixmap object.
+    \param[in] the size of its picture once decoded.
+    \param[in] the page number of the image item.
     \return NONE.
  */
-void SlidingWindow::setImageItemNoPos(QGraphicsPixmapItem* imgItem, QGraphicsSimpleTextItem *imgItemNo,
-                                      QPointF pos, QPixmap pixmap)
+void SlidingWindow::setImageItemNoPos(QGraphicsPixmapItem* imgItem, const QSize &size, int pageNo)
 {
-    if(imgItem == NULL || imgItemNo == NULL)
-    {
-       qDebug("%s - %s(%d) : Passed in simple-text/graphic Pixmap object is NULL!!!",
-               __FILE__, __FUNCTION__, __LINE__);
-       return;
-    }
-
-    if(pixmap.isNull())
+    if(imgItem == NULL)
     {
-       qDebug("%s - %s(%d) : Passed in Pixmap object is NULL!!!",
+       qDebug("%s - %s(%d) : Passed in graphic Pixmap object is NULL!!!",
                __FILE__, __FUNCTION__, __LINE__);
        return;
     }
 
-    imgItemNo->setPos(pos.x()+pixmap.width()-PAGE_NUM_POS_OFFSET_X, pos.y()+pixmap.height()-PAGE_NUM_POS_OFFSET_Y);
+    /* Pictures are added at slide offset 0 and the overlay moves along with
+       them, see moveItem(), so the label position is the same in both. */
+    QPointF pos = imgItem->pos();
 
-    /* Add the new created a page number item to the list. */
-    m_slidePgNumItems += imgItemNo;
+    m_pageNumItem->addLabel(QPointF(pos.x()+size.width()-PAGE_NUM_POS_OFFSET_X,
+                                    pos.y()+size.height()-PAGE_NUM_POS_OFFSET_Y),
+                            pageNo);
 }
-#endif
 
-#ifdef USE_CONTROL_PANEL
 /*! \fn void SlidingWindow::slideLeft()
     \brief The slot to handle sliding items LEFT process.
 
@@ -420,15 +1488,8 @@ void SlidingWindow::slideLeft()
    qDebug(" Push Left button! nOffset = %d", m_nNewPosOfFirstItem);
    #endif
 
-   /* Determine if the timeline is running now. If it is running, just return. */
-   if(m_timelineItem.state() != QTimeLine::NotRunning)
-   {
-      qDebug(" Timeline is still Running! ");
-      return;
-   }
-
    if( !(m_nNewPosOfFirstItem >= ITEM_POS_START_X) )
-     slideBy(SLIDE_OFFSET);
+     slideBy(width());
 }
 
 /*! \fn void SlidingWindow::slideRight()
@@ -443,15 +1504,8 @@ void SlidingWindow::slideRight()
    qDebug(" Push Right button! nOffset = %d", m_nNewPosOfFirstItem);
    #endif
 
-   /* Determine if the timeline is running now. If it is running, just return. */
-   if(m_timelineItem.state() != QTimeLine::NotRunning)
-   {
-      qDebug(" Timeline is still Running! ");
-      return;
-   }
-
-   if( !(m_nNewPosOfFirstItem <= -(SLIDE_OFFSET * (m_slideItems.count()-1))) )
-     slideBy(-SLIDE_OFFSET);
+   if( !(m_nNewPosOfFirstItem <= -(width() * (m_slideItems.count()-1))) )
+     slideBy(-width());
 }
 
 /*! \fn void SlidingWindow::moveItem(int offset)
@@ -466,15 +1520,33 @@ void SlidingWindow::moveItem(int offset)
    qDebug("offset = %d", offset);
    #endif
 
-   for(int i = 0; i < m_slideItems.count(); i++)
-   {
-      /* Move picture items to the new position */
-      m_slideItems[i]->setPos(offset + i * width(), m_slideItems[i]->pos().y());
+   m_nStripOffset = offset;
+   updateVisibleSlides();
+   scheduleSlides();
 
-      /* Move page number items to the new position */
-      m_slidePgNumItems[i]->setPos(m_slideItems[i]->pos().x()+m_slideItems[i]->pixmap().width()-PAGE_NUM_POS_OFFSET_X,
-                                   m_slideItems[i]->pos().y()+m_slideItems[i]->pixmap().height()-PAGE_NUM_POS_OFFSET_Y);
-   }
+   /* Move picture items to the new position, the ones out of the scene are placed when added. */
+   for(int i = m_nFirstInScene; i >= 0 && i <= m_nLastInScene; i++)
+      placeSlide(i);
+
+   /* Move page numbers to the new position */
+   if (m_pageNumItem != NULL)
+      m_pageNumItem->setPos(offset, 0);
+}
+
+/*! \fn void SlidingWindow::stepSlide(qreal progress)
+    \brief The slot moving the items along the running slide animation.
+
+    \param[in] progress the progress of the timeline, 0 to 1.
+    \return NONE.
+ */
+void SlidingWindow::stepSlide(qreal progress)
+{
+   m_motion.setProgress(progress);
+
+   if (testOption(SW_CONTROL_PANEL))
+      moveItem(qRound(m_motion.position()));
+   else
+      horizontalScrollBar()->setValue(qRound(m_motion.position()));
 }
 
 /*! \fn void SlidingWindow::moveItemFinish()
@@ -485,7 +1557,9 @@ void SlidingWindow::moveItem(int offset)
  */
 void SlidingWindow::moveItemFinish()
 {
-   ;
+   /* The next picture of a benchmark starts after this one has settled. */
+   if (m_nBenchStep > 0)
+      QTimer::singleShot(0, this, SLOT(benchmarkStep()));
 
    #ifdef DEBUG
    qDebug("%d nOffset= %d ", __LINE__, m_nNewPosOfFirstItem);
@@ -493,7 +1567,10 @@ void SlidingWindow::moveItemFinish()
 }
 
 /*! \fn void SlidingWindow::slideBy(int distanceX)
-    \brief Start animation of moving items.
+    \brief Start animation of moving items, or move the end of the running one.
+
+    A running animation is retargeted from where the items are, at the speed
+    they move, and reaches the new end one animation duration later.
 
     \param[in] the distance of moving an item.
     \return NONE.
@@ -508,10 +1585,14 @@ void SlidingWindow::slideBy(int distanceX)
           __LINE__, m_nNewPosOfFirstItem, itemStart, itemEnd);
    #endif
 
-   /* Set the animation frame range. */
-   m_timelineItem.setFrameRange(itemStart, itemEnd);
+   /* A new animation starts at the speed of a linear slide and comes to rest at its end. */
+   if (m_timelineItem.state() != QTimeLine::NotRunning)
+      m_motion.retarget(itemEnd);
+   else
+      m_motion.start(m_nStripOffset, itemEnd, itemEnd - m_nStripOffset);
 
-   /* Start the timeline and start do animation. */
+   /* Start the timeline over and start do animation. */
+   m_timelineItem.stop();
    m_timelineItem.start();
 
    /* Update the latest moved distance. */
@@ -523,6 +1604,312 @@ void SlidingWindow::slideBy(int distanceX)
 
    /* If the view reach the LEFT/RIGHT boundary, disable LEFT/RIGHT push button. */
    m_slideControl.pushButtonLeft->setEnabled( !(m_nNewPosOfFirstItem >= ITEM_POS_START_X) );
-   m_slideControl.pushButtonRight->setEnabled( !(m_nNewPosOfFirstItem <= -(SLIDE_OFFSET*(m_slideItems.count()-1))) );
+   m_slideControl.pushButtonRight->setEnabled( !(m_nNewPosOfFirstItem <= -(width()*(m_slideItems.count()-1))) );
+}
+
+/*! \fn void SlidingWindow::goToSlide(int index, bool animate)
+    \brief Show a picture straight away, without passing the pictures in between.
+
+    The view is moved at once, so only the picture and its neighbours enter
+    the scene and get decoded. An animated jump lands next to the picture
+    and slides the last slide width only.
+
+    \param[in] index the index of the picture.
+    \param[in] animate true to slide into the picture, false to cut to it.
+    \return NONE.
+ */
+void SlidingWindow::goToSlide(int index, bool animate)
+{
+   if (m_slideItems.isEmpty() || width() <= 0)
+      return;
+
+   index = qBound(0, index, m_slideItems.count() - 1);
+
+   /* The jump replaces the running slide or flick. */
+   int current = testOption(SW_CONTROL_PANEL) ? -m_nNewPosOfFirstItem / width()
+                                              : horizontalScrollBar()->value() / width();
+   m_timelineItem.stop();
+   m_flickcharm.stop(this);
+
+   int landing = index;
+   if (animate && index != current)
+      landing = (index > current) ? index - 1 : index + 1;
+
+   #ifdef DEBUG
+   qDebug("%s : %s(%d) - slide %d to %d, landing at %d", __FILE__, __FUNCTION__, __LINE__, current, index, landing);
+   #endif
+
+   if (testOption(SW_CONTROL_PANEL))
+   {
+      /* Also brings the pictures into the scene and decodes them. */
+      m_nNewPosOfFirstItem = -landing * width();
+      moveItem(m_nNewPosOfFirstItem);
+
+      /* A cut starts no animation, slideBy() updates the buttons otherwise. */
+      if (landing != index)
+      {
+         slideBy((landing - index) * width());
+         return;
+      }
+
+      /* If the view reach the LEFT/RIGHT boundary, disable LEFT/RIGHT push button. */
+      m_slideControl.pushButtonLeft->setEnabled( !(m_nNewPosOfFirstItem >= ITEM_POS_START_X) );
+      m_slideControl.pushButtonRight->setEnabled( !(m_nNewPosOfFirstItem <= -(width()*(m_slideItems.count()-1))) );
+      return;
+   }
+
+   m_bJumping = true;
+   horizontalScrollBar()->setValue(landing * width());
+   m_bJumping = false;
+
+   if (landing != index)
+   {
+      m_motion.start(landing * width(), index * width(), (index - landing) * width());
+      m_timelineItem.start();
+   }
+}
+
+/*! \fn void SlidingWindow::startBenchmark(int sweeps)
+    \brief Slide from the first picture to the last one and back, measuring each frame, then emit benchmarkFinished().
+
+    The pictures are slid one by one with the configured animation, the
+    same path on every run, so runs of two builds or two rendering profiles
+    on a device can be compared. The pictures are decoded while sliding as
+    they are when browsing. The painting times are measured with
+    QElapsedTimer, in nanoseconds.
+
+    \param[in] sweeps the times to slide to the last picture and back.
+    \return NONE.
+ */
+void SlidingWindow::startBenchmark(int sweeps)
+{
+   m_nBenchSweeps = qMax(1, sweeps);
+   m_nBenchStep = 0;
+   m_benchStats.clear();
+
+   goToSlide(0, false);
+
+   /* The frames of the window showing up are not part of the sweep. */
+   QTimer::singleShot(BENCHMARK_SETTLE_TIME, this, SLOT(benchmarkStep()));
+}
+
+/*! \fn void SlidingWindow::benchmarkStep()
+    \brief Slide to the next picture of the benchmark, or report it when all sweeps are done.
+
+    \param[in] NONE.
+    \return NONE.
+ */
+void SlidingWindow::benchmarkStep()
+{
+   if (m_nBenchStep < 0)
+      return;
+
+   int last = m_slideItems.count() - 1;
+   int steps = 2 * qMax(0, last) * m_nBenchSweeps;
+
+   if (m_nBenchStep == 0)
+      m_benchClock.start();
+
+   if (m_nBenchStep >= steps)
+   {
+      qint64 elapsed = m_benchClock.nsecsElapsed();
+      m_nBenchStep = -1;
+
+      emit benchmarkFinished(QString("%1 sweeps of %2 pictures in %3 ms, %4").arg(m_nBenchSweeps).arg(last + 1)
+                             .arg(elapsed / 1000000.0, 0, 'f', 3).arg(m_benchStats.summary()));
+      return;
+   }
+
+   /* Forward to the last picture, then back to the first one. */
+   int turn = m_nBenchStep % (2 * last);
+   int index = (turn < last) ? turn + 1 : 2 * last - turn - 1;
+
+   m_nBenchStep++;
+   goToSlide(index, true);
+}
+
+/*! \fn PageNumberItem::PageNumberItem(QGraphicsItem *parent)
+    \brief Constructor
+
+    \param[in] parent the parent item.
+ */
+PageNumberItem::PageNumberItem(QGraphicsItem *parent)
+    : QGraphicsItem(parent)
+    , m_glyphMargin(0)
+    , m_nSlideWidth(0)
+{
+    /* Paint needs the exposed rectangle to draw only the visible labels. */
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+
+    buildGlyphStrip();
+}
+
+/*! \fn void PageNumberItem::buildGlyphStrip()
+    \brief Render all glyphs of page numbers with the page number pen and brush.
+
+    \param[in] NONE.
+    \return NONE.
+ */
+void PageNumberItem::buildGlyphStrip()
+{
+    const QString glyphs(PAGE_NUM_GLYPHS);
+    QFont font("Arial", 14);  // the font of page number.
+    QFontMetrics metrics(font);
+    QPen pen;  // the Pen object for draw page number of each picture.
+    QBrush brush(Qt::SolidPattern);
+
+    /* Configure the Pen object. */
+    pen.setWidth(2);
+    pen.setColor(QColor(105, 158, 0, 255)); // R, G, B, Alpha
+    pen.setStyle(Qt::SolidLine);
+    pen.setCapStyle(Qt::RoundCap);
+    pen.setJoinStyle(Qt::RoundJoin);
+
+    /* Give each glyph its own cell with room for the outline. */
+    m_glyphMargin = pen.width();
+    m_glyphX.clear();
+    m_glyphWidth.clear();
+
+    int stripWidth = 0;
+    QPainterPath path;
+    for (int i = 0; i < glyphs.length(); i++)
+    {
+        m_glyphX << stripWidth + m_glyphMargin;
+        m_glyphWidth << metrics.width(glyphs.at(i));
+        path.addText(m_glyphX[i], m_glyphMargin + metrics.ascent(), font, QString(glyphs.at(i)));
+        stripWidth += m_glyphWidth[i] + 2 * m_glyphMargin;
+    }
+
+    m_glyphStrip = QPixmap(stripWidth, metrics.height() + 2 * m_glyphMargin);
+    m_glyphStrip.fill(Qt::transparent);
+
+    QPainter painter(&m_glyphStrip);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(pen);
+    painter.setBrush(brush);
+    painter.drawPath(path);
+}
+
+/*! \fn int PageNumberItem::labelWidth(const QString &label) const
+    \brief Return the width of a label drawn from the glyph strip.
+
+    \param[in] label the text of the label.
+    \return the width including the outline.
+ */
+int PageNumberItem::labelWidth(const QString &label) const
+{
+    const QString glyphs(PAGE_NUM_GLYPHS);
+    int width = 2 * m_glyphMargin;
+
+    for (int i = 0; i < label.length(); i++)
+        width += m_glyphWidth[glyphs.indexOf(label.at(i))];
+
+    return width;
+}
+
+/*! \fn void PageNumberItem::setSlideWidth(int width)
+    \brief Set the distance between two pictures, the label of picture N is within [N*width, (N+1)*width).
+
+    \param[in] width the distance between two pictures.
+    \return NONE.
+ */
+void PageNumberItem::setSlideWidth(int width)
+{
+    m_nSlideWidth = width;
+    update();
+}
+
+/*! \fn void PageNumberItem::addLabel(const QPointF &pos, int pageNo)
+    \brief Add the label of the next picture.
+
+    \param[in] pos the top-left position of the label.
+    \param[in] pageNo the page number of the picture.
+    \return NONE.
+ */
+void PageNumberItem::addLabel(const QPointF &pos, int pageNo)
+{
+    QRectF labelRect(pos.x() - m_glyphMargin, pos.y() - m_glyphMargin,
+                     labelWidth(QString("P.%1").arg(pageNo)), m_glyphStrip.height());
+
+    prepareGeometryChange();
+    m_bounds |= labelRect;
+
+    m_labelPos += pos;
+    m_labelPageNo += pageNo;
+}
+
+/*! \fn void PageNumberItem::clearLabels()
+    \brief Remove the labels of all pictures.
+
+    \param[in] NONE.
+    \return NONE.
+ */
+void PageNumberItem::clearLabels()
+{
+    prepareGeometryChange();
+    m_bounds = QRectF();
+
+    m_labelPos.clear();
+    m_labelPageNo.clear();
+}
+
+/*! \fn QRectF PageNumberItem::boundingRect() const
+    \brief Return the bounding rectangle of all labels.
+
+    \param[in] NONE.
+    \return the bounding rectangle.
+ */
+QRectF PageNumberItem::boundingRect() const
+{
+    return m_bounds;
+}
+
+/*! \fn void PageNumberItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+    \brief Draw the labels of the exposed pictures from the glyph strip.
+
+    \param[in] QPainter object.
+    \param[in] QStyleOptionGraphicsItem object.
+    \param[in] QWidget object.
+    \return NONE.
+ */
+void PageNumberItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(widget);
+
+    if (m_labelPos.isEmpty() || m_nSlideWidth <= 0)
+       return;
+
+    /* Only the pictures under the exposed rectangle have their label drawn. */
+    int first = qMax(0, static_cast<int>(qFloor(option->exposedRect.left() / m_nSlideWidth)));
+    int last = qMin(m_labelPos.count() - 1, static_cast<int>(qFloor(option->exposedRect.right() / m_nSlideWidth)));
+
+    for (int i = first; i <= last; i++)
+        drawLabel(painter, i);
+}
+
+/*! \fn void PageNumberItem::drawLabel(QPainter *painter, int index) const
+    \brief Draw the label of a picture by copying its glyphs from the strip.
+
+    \param[in] QPainter object.
+    \param[in] index the index of the picture.
+    \return NONE.
+ */
+void PageNumberItem::drawLabel(QPainter *painter, int index) const
+{
+    if (index < 0 || index >= m_labelPos.count())
+       return;
+
+    const QString glyphs(PAGE_NUM_GLYPHS);
+    const QString label = QString("P.%1").arg(m_labelPageNo[index]);
+    qreal x = m_labelPos[index].x();
+
+    for (int j = 0; j < label.length(); j++)
+    {
+        int glyph = glyphs.indexOf(label.at(j));
+
+        painter->drawPixmap(QPointF(x - m_glyphMargin, m_labelPos[index].y() - m_glyphMargin), m_glyphStrip,
+                            QRectF(m_glyphX[glyph] - m_glyphMargin, 0,
+                                   m_glyphWidth[glyph] + 2 * m_glyphMargin, m_glyphStrip.height()));
+        x += m_glyphWidth[glyph];
+    }
 }
-#endif
@@ -27,9 +27,74 @@
 
 #include "ui_SlidingWindowControl.h"
 #include "flickcharm.h"
+#include "SlideLoader.h"
+#include "SlideBundle.h"
+#include "SlideCache.h"
+#include "MemoryMonitor.h"
+#include "SlideMotion.h"
+#include "FrameStats.h"
+#include "ScrubberBar.h"
+#include "DeepZoomView.h"
 
 class QPropertyAnimation;
 
+/*! \enum SlidingWindowOption
+    \brief The features of the sliding window which can be switched at runtime.
+*/
+enum SlidingWindowOption{
+    SW_TRANSPARENT_FRAME = 0x01,  /*!< Transparent window frame, needs a compositing manager. */
+    SW_PAGE_NUM = 0x02,           /*!< Show the page number of each picture. */
+    SW_CONTROL_PANEL = 0x04,      /*!< Slide with the control panel instead of flicking. */
+    SW_TILE_COMPOSITOR = 0x08,    /*!< Copy the slides into the viewport without the scene. Switched off with SW_TRANSPARENT_FRAME, e.g. "-notransparent" is needed. */
+    SW_THUMB_SCRUBBER = 0x10,     /*!< Show the thumbnail strip to browse the slides. */
+    SW_DEEP_ZOOM = 0x20           /*!< Zoom into the pictures at full resolution with the wheel or a pinch. */
+};
+
+/* The features of the sliding window by default. */
+#define DFLT_SLIDING_WINDOW_OPTIONS  (SW_TRANSPARENT_FRAME | SW_PAGE_NUM)
+
+/*! \class PageNumberItem
+    \brief The overlay drawing the page numbers of the visible pictures.
+
+    The glyphs of the page numbers are rendered once into a strip, and a label
+    is drawn by copying its glyphs from the strip, only for the exposed pictures.
+*/
+class PageNumberItem : public QGraphicsItem
+{
+public:
+    PageNumberItem(QGraphicsItem *parent = 0);  /*!< Constructor */
+
+    void setSlideWidth(int width);
+    void addLabel(const QPointF &pos, int pageNo);
+    void clearLabels();
+    void drawLabel(QPainter *painter, int index) const;  /*!< Draw the label of a picture. */
+
+    QRectF boundingRect() const;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
+
+private:
+    void buildGlyphStrip();
+    int labelWidth(const QString &label) const;
+
+    QPixmap m_glyphStrip;       /*!< The glyphs of PAGE_NUM_GLYPHS with outline, side by side. */
+    QVector<int> m_glyphX;      /*!< The x-axis position of each glyph in the strip. */
+    QVector<int> m_glyphWidth;  /*!< The advance of each glyph. */
+    int m_glyphMargin;          /*!< The room for the outline around each glyph. */
+    QList<QPointF> m_labelPos;  /*!< The top-left position of the label of each picture. */
+    QList<int> m_labelPageNo;   /*!< The page number of each picture. */
+    QRectF m_bounds;            /*!< The bounding rectangle of all labels. */
+    int m_nSlideWidth;          /*!< The distance between two pictures. */
+};
+
+/*! \enum RenderProfile
+    \brief The named sets of viewport update mode, optimization flags, cache mode and render hints.
+*/
+enum RenderProfile{
+    RENDER_DEFAULT = 0,  /*!< Qt's defaults. */
+    RENDER_LOW_POWER,    /*!< The fewest CPU cycles per frame, e.g. for embedded devices. */
+    RENDER_QUALITY       /*!< Antialiased and smoothly transformed drawing. */
+};
+
 /*! \class SlidingWindow
     \brief The sliding window class.
 */
@@ -38,56 +103,117 @@ class SlidingWindow : public QGraphicsView
 Q_OBJECT
 
 public:
-    SlidingWindow();  /*!< Constructor */
+    SlidingWindow(int options = DFLT_SLIDING_WINDOW_OPTIONS);  /*!< Constructor */
+    ~SlidingWindow();  /*!< Destructor */
+
+    bool testOption(SlidingWindowOption option) const;  /*!< Whether a feature is switched on. */
+
+    void setRenderProfile(RenderProfile profile);  /*!< Tune the view for power or quality. */
+    RenderProfile renderProfile() const;
+    static QString renderProfileName(RenderProfile profile);  /*!< The name of a profile in the layout file. */
+    static RenderProfile renderProfileFromName(const QString &name, bool *ok = 0);
 
 private:
     QGraphicsScene m_scene;       /*!< The canvas */
     QGraphicsItem *m_background;  /*!< The sliding window background picture. */
     QList<QGraphicsPixmapItem*> m_slideItems;  /*!< The list of items of QWidget type. */
-    QString m_imageDir;
-
-    #ifdef ADD_PAGE_NUM
-    QGraphicsSimpleTextItem *m_textItem;  /*!< To hold the new created text item instance. */
-    QList<QGraphicsSimpleTextItem*> m_slidePgNumItems;  /*!< The list of items of QWidget type. */
-    #endif
+    QString m_imageDir;        /*!< The folder of the pictures, or a slide bundle file. */
+    QSize m_layoutSize;        /*!< The window size the slides are scaled and placed for. */
+    int m_nAnimationDuration;  /*!< The duration of the slide animation in milliseconds. */
+
+    RenderProfile m_renderProfile;  /*!< The rendering profile of the view. */
+    bool m_bReportFrameTime;        /*!< Print the painting time of the frames. */
+    FrameStats m_frameStats;        /*!< The painting times since the last report. */
+    FrameStats m_benchStats;        /*!< The painting times of the running benchmark. */
+    QElapsedTimer m_benchClock;     /*!< The duration of the running benchmark. */
+    int m_nBenchSweeps;             /*!< The sweeps of the running benchmark. */
+    int m_nBenchStep;               /*!< The next slide of the running benchmark, -1 when not running. */
+    int m_nOptions;            /*!< The switched on features, OR-ed SlidingWindowOption values. */
+    int m_nStripOffset;        /*!< The x-axis position of the first slide, moved by the control panel. */
+    int m_nFirstInScene;       /*!< The first slide added to the scene, -1 for none. */
+    int m_nLastInScene;        /*!< The last slide added to the scene, -1 for none. */
+    QHash<int, QImage> m_slideTiles;  /*!< The window-sized RGB32 tiles of the slides in the scene, for SW_TILE_COMPOSITOR. */
+    QStringList m_slideFiles;         /*!< The picture file of each slide. */
+    QList<QSize> m_slideSizes;        /*!< The size of each picture once decoded and scaled. */
+    QSet<int> m_loadedSlides;         /*!< The slides holding their decoded picture. */
+    QSet<int> m_placeholderSlides;    /*!< The slides showing their EXIF thumbnail until decoded. */
+    SlideLoader m_slideLoader;        /*!< Decodes the pictures around the view off the GUI thread. */
+    SlideBundle m_bundle;             /*!< The mapped slide bundle when m_imageDir names one. */
+    SlideCache m_slideCache;          /*!< The compressed slides released from the view. */
+    QHash<int, QByteArray> m_packedSlides;  /*!< The packed pictures of the decoded slides, moved into m_slideCache when released. */
+    int m_nResidentRadius;            /*!< The configured m_nKeepRadius, without memory pressure. */
+    int m_nCacheKBytes;               /*!< The configured budget of m_slideCache, without memory pressure. */
+    int m_nKeepRadius;                /*!< The slides farther from the view release their pixmaps. */
+    bool m_bReportCacheHits;          /*!< Print the hit rate of the compressed tier. */
+    MemoryMonitor m_memoryMonitor;    /*!< Reports the memory pressure of the device. */
+    int m_nMemPollInterval;           /*!< The memory sampling interval in milliseconds, 0 for none. */
+    int m_nScrollSpeed;               /*!< The distance of the last scroll, in pixels per FlickCharm tick. */
+    bool m_bJumping;                  /*!< The view is moved by goToSlide(), not scrolled. */
+    ScrubberBar *m_scrubber;          /*!< The thumbnail strip, NULL without SW_THUMB_SCRUBBER. */
+    bool m_bScrubbing;                /*!< The thumbnail strip is dragged, the slides show their thumbnails. */
+    DeepZoomView *m_deepZoom;         /*!< The full resolution view of a picture, NULL without SW_DEEP_ZOOM. */
+    QString m_tileCacheDir;           /*!< The folder caching the tile pyramids of the pictures. */
+    int m_nTileDiskMBytes;            /*!< The disk space of the tile pyramids, the least recently used go first. */
+    int m_nTileCacheKBytes;           /*!< The configured budget of the tiles in memory, without memory pressure. */
+    int m_nTileBufferKBytes;          /*!< The memory for a band of a picture while building its pyramid. */
+
+    PageNumberItem *m_pageNumItem;  /*!< The page numbers of all pictures, NULL without SW_PAGE_NUM. */
 
-    #ifdef USE_CONTROL_PANEL
     QTimeLine m_timelineItem;             /*!< The timeline for sliding window items. */
+    SlideMotion m_motion;                 /*!< The path of the running slide, retargeted by new slides. */
     Ui::ControlPanelForm m_slideControl;  /*!< The form constructed from UI designer. */
     int m_nNewPosOfFirstItem;             /*!< The current starting position of X-axis. */
-    #endif
 
-    #ifndef USE_CONTROL_PANEL
-    FlickCharm m_flickcharm;
-    #endif
+    FlickCharm m_flickcharm;  /*!< Only activated when the control panel is not used. */
 
 public:
-    void setImageItemPos(QGraphicsPixmapItem *imgItem);  /*!< Set the position of each picture item. */
-
-    #ifdef ADD_PAGE_NUM
-    void setImageItemNoPos(QGraphicsPixmapItem *imgItem, QGraphicsSimpleTextItem *imgItemNo,
-                           QPointF pos, QPixmap pixmap);  /*!< Set the position of NO. of each picture. */
-    #endif
-
-    #ifdef USE_CONTROL_PANEL
+    void setImageItemPos(QGraphicsPixmapItem *imgItem, const QSize &size);  /*!< Set the position of each picture item. */
+    void setImageItemNoPos(QGraphicsPixmapItem *imgItem, const QSize &size, int pageNo);  /*!< Set the position of NO. of each picture. */
     void slideBy(int distanceX);
-    #endif
+    void goToSlide(int index, bool animate = true);  /*!< Show a picture without passing the ones in between. */
+    void startBenchmark(int sweeps);  /*!< Slide through all pictures and back, then report the painting times. */
 
 protected:
+    QSize loadLayout();  /*!< Load the window geometry and slide layout. */
     void addImages();  /*!< Add default pictures into sliding window */
+    void addBundle();  /*!< Add the pictures of a slide bundle. */
+    void resizeEvent(QResizeEvent *event);
+    void paintEvent(QPaintEvent *event);
+    void wheelEvent(QWheelEvent *event);
+    bool viewportEvent(QEvent *event);
+    void paintSlides(QPaintEvent *event);
+    const QImage &slideTile(int index);            /*!< The tile of a picture for SW_TILE_COMPOSITOR. */
+    void compositeSlides(const QRect &exposed);    /*!< Blit the tiles under the view into the viewport. */
+    void scrollContentsBy(int dx, int dy);
+    void placeSlide(int index);     /*!< Put a picture item at its place on the slide strip. */
+    void updateVisibleSlides();     /*!< Keep only the pictures around the view in the scene. */
+    void scheduleSlides();          /*!< Decode the pictures around the view, release the far ones. */
+    void showPlaceholder(int index);  /*!< Show the EXIF thumbnail of a picture until it is decoded. */
+    void showThumbnail(int index, const QImage &thumbnail);  /*!< Stretch a thumbnail over a slide. */
+    void placeScrubber();             /*!< Put the thumbnail strip over the bottom of the view. */
+    bool openDeepZoom();              /*!< Show the picture of the current slide at full resolution. */
+    void requestSlide(int index);     /*!< Queue a picture, from the compressed tier when it is there. */
+
+signals:
+    void benchmarkFinished(const QString &summary);  /*!< The painting times of the benchmark. */
 
 public slots:
-    #ifdef USE_CONTROL_PANEL
     /* The event handlers for buttons to move items. */
     void slideLeft();
     void slideRight();
-    #endif
 
 private slots:
-    #ifdef USE_CONTROL_PANEL
     void moveItem(int nOffset);  /*!< For moving items. */
+    void stepSlide(qreal progress);  /*!< Move the items along the running slide. */
     void moveItemFinish();
-    #endif
+    void benchmarkStep();  /*!< Slide to the next picture of the benchmark, or report it. */
+    void slideLoaded(int index, const QImage &image, const QByteArray &packed = QByteArray(),
+                     const QImage &thumbnail = QImage());  /*!< Show a decoded picture. */
+    void slideCancelled(int index, const QByteArray &packed);  /*!< Put a packed slide back into the compressed tier. */
+    void memoryPressureChanged(int pressure);  /*!< Shed or regrow the caches. */
+    void slideScrubbed(int index);  /*!< Cut to the slide under the dragged thumbnail strip. */
+    void scrubFinished(int index);  /*!< Decode the slide the thumbnail strip was left on. */
+    void deepZoomClosed();  /*!< Back to the slides when the zoomed picture closes. */
 };
 
 #endif /* SLIDINGWINDOW_H */
@@ -9,15 +9,25 @@ DEPENDPATH += . FlickCharm
 INCLUDEPATH += . FlickCharm
 
 # Input
-HEADERS += SlidingWindow.h FlickCharm/flickcharm.h
+HEADERS += SlidingWindow.h SlideBenchmark.h ImageScaler.h SlideLoader.h ExifReader.h SlideBundle.h SlideCache.h MemoryMonitor.h SlideMotion.h FrameStats.h ThumbnailAtlas.h ThumbnailLoader.h ScrubberBar.h TilePyramid.h TileLoader.h DeepZoomView.h FlickCharm/flickcharm.h
 FORMS += SlidingWindowControl.ui
-SOURCES += main.cpp SlidingWindow.cpp FlickCharm/flickcharm.cpp
-
-DEFINES += ENABLE_TRANSPARENT_FRAME
-DEFINES += ADD_PAGE_NUM
-#DEFINES += USE_CONTROL_PANEL
+SOURCES += main.cpp SlidingWindow.cpp SlideBenchmark.cpp ImageScaler.cpp SlideLoader.cpp ExifReader.cpp SlideBundle.cpp SlideCache.cpp MemoryMonitor.cpp SlideMotion.cpp FrameStats.cpp ThumbnailAtlas.cpp ThumbnailLoader.cpp ScrubberBar.cpp TilePyramid.cpp TileLoader.cpp DeepZoomView.cpp FlickCharm/flickcharm.cpp
 
 QT += gui
 # Added for Qt5, 2015-09-10. Begin
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets concurrent
 # Added for Qt5, 2015-09-10. End
+
+# Qt5 asks X11 through QtX11Extras whether a compositing manager runs, see isCompositingManagerRunning().
+greaterThan(QT_MAJOR_VERSION, 4):unix:!macx:qtHaveModule(x11extras) {
+    QT += x11extras
+    DEFINES += HAVE_X11EXTRAS
+    lessThan(QT_MINOR_VERSION, 7): LIBS += -lxcb
+}
+
+# Deep zoom decodes JPEG pictures scanline by scanline with libjpeg, built with "qmake CONFIG+=libjpeg" only.
+# Without it, the pictures are decoded by QImageReader and no third-party library is needed.
+libjpeg {
+    DEFINES += HAVE_LIBJPEG
+    LIBS += -ljpeg
+}
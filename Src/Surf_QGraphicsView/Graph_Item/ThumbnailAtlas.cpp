@@ -0,0 +1,139 @@
+/*! \file  ThumbnailAtlas.cpp
+    \brief Implementation of ThumbnailAtlas class.
+ */
+
+#include <QPainter>
+#include <QtGlobal>
+
+#include "ThumbnailAtlas.h"
+
+/*! \fn ThumbnailAtlas::ThumbnailAtlas(const QSize &cellSize, int columns, int rows)
+    \brief Constructor, allocate the atlas image once.
+
+    \param[in] cellSize the largest thumbnail.
+    \param[in] columns the cells in a row of the atlas.
+    \param[in] rows the rows of cells of the atlas.
+ */
+ThumbnailAtlas::ThumbnailAtlas(const QSize &cellSize, int columns, int rows)
+    : m_image(cellSize.width() * columns, cellSize.height() * rows, QImage::Format_ARGB32_Premultiplied)
+    , m_cellSize(cellSize)
+    , m_nColumns(columns)
+    , m_cellSlide(columns * rows, -1)
+    , m_cellUsed(columns * rows)
+    , m_cellStamp(columns * rows, 0)
+    , m_nStamp(0)
+{
+    m_image.fill(0);
+}
+
+/*! \fn QSize ThumbnailAtlas::cellSize() const
+    \brief Return the size of a cell, the largest thumbnail.
+
+    \param[in] NONE.
+    \return the cell size.
+ */
+QSize ThumbnailAtlas::cellSize() const
+{
+    return m_cellSize;
+}
+
+/*! \fn bool ThumbnailAtlas::contains(int index) const
+    \brief Check if the thumbnail of a slide is in the atlas.
+
+    \param[in] index the index of the slide.
+    \return true if it is there.
+ */
+bool ThumbnailAtlas::contains(int index) const
+{
+    return m_cells.contains(index);
+}
+
+/*! \fn QRect ThumbnailAtlas::find(int index)
+    \brief Return where the thumbnail of a slide is, it becomes the most recently used one.
+
+    \param[in] index the index of the slide.
+    \return the rectangle in image(), null if the thumbnail is not there.
+ */
+QRect ThumbnailAtlas::find(int index)
+{
+    QHash<int, int>::const_iterator it = m_cells.constFind(index);
+    if (it == m_cells.constEnd())
+       return QRect();
+
+    int cell = it.value();
+    m_cellStamp[cell] = ++m_nStamp;
+
+    return QRect(QPoint((cell % m_nColumns) * m_cellSize.width(), (cell / m_nColumns) * m_cellSize.height()),
+                 m_cellUsed[cell]);
+}
+
+/*! \fn void ThumbnailAtlas::insert(int index, const QImage &thumbnail)
+    \brief Copy a thumbnail into a free cell, or into the least recently used one.
+
+    \param[in] index the index of the slide.
+    \param[in] thumbnail the thumbnail, cropped to the cell size if larger.
+    \return NONE.
+ */
+void ThumbnailAtlas::insert(int index, const QImage &thumbnail)
+{
+    if (thumbnail.isNull() || m_cellSlide.isEmpty())
+       return;
+
+    int cell = m_cells.value(index, -1);
+
+    /* A free cell, or the one drawn the longest ago. */
+    if (cell < 0)
+    {
+       cell = 0;
+       for (int i = 0; i < m_cellSlide.count(); i++)
+       {
+          if (m_cellSlide[i] < 0)
+          {
+             cell = i;
+             break;
+          }
+
+          if (m_cellStamp[i] < m_cellStamp[cell])
+             cell = i;
+       }
+
+       if (m_cellSlide[cell] >= 0)
+          m_cells.remove(m_cellSlide[cell]);
+
+       m_cellSlide[cell] = index;
+       m_cells.insert(index, cell);
+    }
+
+    m_cellUsed[cell] = thumbnail.size().boundedTo(m_cellSize);
+    m_cellStamp[cell] = ++m_nStamp;
+
+    QPainter painter(&m_image);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.drawImage(QPoint((cell % m_nColumns) * m_cellSize.width(), (cell / m_nColumns) * m_cellSize.height()),
+                      thumbnail, QRect(QPoint(0, 0), m_cellUsed[cell]));
+}
+
+/*! \fn void ThumbnailAtlas::clear()
+    \brief Drop all thumbnails, e.g. for another set of slides.
+
+    \param[in] NONE.
+    \return NONE.
+ */
+void ThumbnailAtlas::clear()
+{
+    m_cells.clear();
+    m_cellSlide.fill(-1);
+    m_cellStamp.fill(0);
+    m_nStamp = 0;
+}
+
+/*! \fn const QImage &ThumbnailAtlas::image() const
+    \brief Return the atlas image the thumbnails are drawn from.
+
+    \param[in] NONE.
+    \return the atlas image.
+ */
+const QImage &ThumbnailAtlas::image() const
+{
+    return m_image;
+}
@@ -0,0 +1,45 @@
+/*! \file  ThumbnailAtlas.h
+    \brief Declaration of ThumbnailAtlas class.
+ */
+
+#ifndef THUMBNAILATLAS_H
+#define THUMBNAILATLAS_H
+
+#include <QImage>
+#include <QSize>
+#include <QRect>
+#include <QHash>
+#include <QVector>
+
+/*! \class ThumbnailAtlas
+    \brief The thumbnails of the slides packed into one image of fixed cells.
+
+    The atlas holds as many thumbnails as it has cells whatever the number of
+    slides, the least recently drawn thumbnail gives its cell up to a new one.
+    Drawing a thumbnail is a copy of its cell, from the same image for all.
+*/
+class ThumbnailAtlas
+{
+public:
+    ThumbnailAtlas(const QSize &cellSize, int columns, int rows);  /*!< Constructor */
+
+    QSize cellSize() const;
+    bool contains(int index) const;
+    QRect find(int index);  /*!< The rectangle of a thumbnail in image(), null if not there. */
+    void insert(int index, const QImage &thumbnail);  /*!< Put a thumbnail fitting a cell into the atlas. */
+    void clear();
+
+    const QImage &image() const;
+
+private:
+    QImage m_image;
+    QSize m_cellSize;
+    int m_nColumns;
+    QHash<int, int> m_cells;      /*!< The cell of each slide in the atlas. */
+    QVector<int> m_cellSlide;     /*!< The slide in each cell, -1 for none. */
+    QVector<QSize> m_cellUsed;    /*!< The size of the thumbnail in each cell. */
+    QVector<quint32> m_cellStamp; /*!< When each cell was last drawn or filled. */
+    quint32 m_nStamp;
+};
+
+#endif /* THUMBNAILATLAS_H */
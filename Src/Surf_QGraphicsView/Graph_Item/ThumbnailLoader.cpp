@@ -0,0 +1,247 @@
+/*! \file  ThumbnailLoader.cpp
+    \brief Implementation of ThumbnailLoader class.
+ */
+
+#include <QImageReader>
+#include <QMutexLocker>
+#include <QtGlobal>
+
+#include "ThumbnailLoader.h"
+#include "ImageScaler.h"
+#include "ExifReader.h"
+#include "SlideBundle.h"
+
+/*! \fn ThumbnailLoader::ThumbnailLoader(const QSize &size, QObject *parent)
+    \brief Constructor, start the worker thread at low priority.
+
+    \param[in] size the box the thumbnails fit in.
+    \param[in] parent the parent object.
+ */
+ThumbnailLoader::ThumbnailLoader(const QSize &size, QObject *parent)
+    : QThread(parent)
+    , m_size(size)
+    , m_nBusy(-1)
+    , m_nGeneration(0)
+    , m_bDeferFullDecode(false)
+    , m_bQuit(false)
+{
+    /* The thumbnails are made on the worker and shown on the GUI thread. */
+    QObject::connect(this, SIGNAL(loaded(int, int, QImage)), this, SLOT(onLoaded(int, int, QImage)), Qt::QueuedConnection);
+
+    start(QThread::LowestPriority);
+}
+
+/*! \fn ThumbnailLoader::~ThumbnailLoader()
+    \brief Destructor, stop the worker thread.
+ */
+ThumbnailLoader::~ThumbnailLoader()
+{
+    {
+       QMutexLocker locker(&m_mutex);
+       m_bQuit = true;
+       m_requested.wakeAll();
+    }
+
+    wait();
+}
+
+/*! \fn void ThumbnailLoader::setFiles(const QStringList &files)
+    \brief Make the thumbnails of picture files, dropping the pending ones.
+
+    \param[in] files the picture file of each slide.
+    \return NONE.
+ */
+void ThumbnailLoader::setFiles(const QStringList &files)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_files = files;
+    m_bundleFile.clear();
+    m_pending.clear();
+    m_nGeneration++;
+}
+
+/*! \fn void ThumbnailLoader::setBundle(const QString &fileName)
+    \brief Make the thumbnails of the slides of a bundle, dropping the pending ones.
+
+    \param[in] fileName the slide bundle, mapped again by the worker.
+    \return NONE.
+ */
+void ThumbnailLoader::setBundle(const QString &fileName)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_files.clear();
+    m_bundleFile = fileName;
+    m_pending.clear();
+    m_nGeneration++;
+}
+
+/*! \fn void ThumbnailLoader::request(const QList<int> &indices)
+    \brief Replace the pending thumbnails, e.g. with the ones now visible.
+
+    \param[in] indices the slides, the most urgent first.
+    \return NONE.
+ */
+void ThumbnailLoader::request(const QList<int> &indices)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_pending = indices;
+    m_pending.removeAll(m_nBusy);
+    m_requested.wakeOne();
+}
+
+/*! \fn void ThumbnailLoader::setDeferFullDecode(bool defer)
+    \brief Skip the pictures with neither an EXIF thumbnail nor a scaled decode, e.g. a PNG
+           while the strip is dragged. The skipped slides are not reported, request them again.
+
+    \param[in] defer true to skip them, false to make them again.
+    \return NONE.
+ */
+void ThumbnailLoader::setDeferFullDecode(bool defer)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_bDeferFullDecode = defer;
+}
+
+/*! \fn void ThumbnailLoader::onLoaded(int index, int generation, const QImage &thumbnail)
+    \brief Pass on a thumbnail made for the current set of slides.
+
+    \param[in] index the index of the slide.
+    \param[in] generation the set of slides it was made for.
+    \param[in] thumbnail the thumbnail, null if the picture could not be read.
+    \return NONE.
+ */
+void ThumbnailLoader::onLoaded(int index, int generation, const QImage &thumbnail)
+{
+    {
+       QMutexLocker locker(&m_mutex);
+       if (generation != m_nGeneration)
+          return;
+    }
+
+    emit thumbnailLoaded(index, thumbnail);
+}
+
+/*! \fn void ThumbnailLoader::run()
+    \brief Make the first pending thumbnail until the loader quits.
+
+    \param[in] NONE.
+    \return NONE.
+ */
+void ThumbnailLoader::run()
+{
+    SlideBundle bundle;  /* Mapped on this thread, the window may close its own mapping. */
+    QString bundleFile;
+
+    forever
+    {
+       int index, generation;
+       QString fileName, wantedBundle;
+       bool deferFullDecode;
+       {
+          QMutexLocker locker(&m_mutex);
+
+          m_nBusy = -1;
+          while (!m_bQuit && m_pending.isEmpty())
+             m_requested.wait(&m_mutex);
+
+          if (m_bQuit)
+             return;
+
+          index = m_pending.takeFirst();
+          m_nBusy = index;
+          generation = m_nGeneration;
+          fileName = m_files.value(index);
+          wantedBundle = m_bundleFile;
+          deferFullDecode = m_bDeferFullDecode;
+       }
+
+       if (wantedBundle != bundleFile)
+       {
+          bundle.close();
+          if (!wantedBundle.isEmpty())
+             bundle.open(wantedBundle);
+          bundleFile = wantedBundle;
+       }
+
+       QImage thumbnail;
+       bool deferred = false;
+       if (bundle.isOpen())
+          thumbnail = fitted(bundle.slide(index));
+       else if (!fileName.isEmpty())
+          thumbnail = readThumbnail(fileName, deferFullDecode, &deferred);
+
+       if (!deferred)
+          emit loaded(index, generation, thumbnail);
+    }
+}
+
+/*! \fn QImage ThumbnailLoader::readThumbnail(const QString &fileName, bool deferFullDecode, bool *deferred) const
+    \brief Make the thumbnail of a picture file, upright.
+
+    \param[in] fileName the picture file.
+    \param[in] deferFullDecode true to skip a picture which can only be fully decoded.
+    \param[out] deferred true if the picture was skipped.
+    \return the thumbnail, null if the picture could not be read or was skipped.
+ */
+QImage ThumbnailLoader::readThumbnail(const QString &fileName, bool deferFullDecode, bool *deferred) const
+{
+    ExifReader exif(fileName);
+    QImage image = exif.thumbnail();
+
+    /* Without an EXIF thumbnail, decode the picture at about the thumbnail size. */
+    if (image.isNull())
+    {
+       QImageReader reader(fileName);
+
+       /* Only a handler with a scaled decode, as JPEG, reads a fraction of the picture. */
+       if (deferFullDecode && !reader.supportsOption(QImageIOHandler::ScaledSize))
+       {
+          *deferred = true;
+          return QImage();
+       }
+
+       #if QT_VERSION >= 0x050500
+       reader.setAutoTransform(false);  /* Turned upright below, once scaled. */
+       #endif
+
+       QSize box = m_size;
+       if (ExifReader::isTransposed(exif.orientation()))
+          box.transpose();
+
+       if (reader.size().isValid())
+          reader.setScaledSize(reader.size().boundedTo(reader.size().scaled(box, Qt::KeepAspectRatio)));
+
+       image = reader.read();
+    }
+
+    if (image.isNull())
+       return image;
+
+    if (exif.orientation() != 1)
+       image = image.transformed(ExifReader::orientationTransform(exif.orientation()));
+
+    return fitted(image);
+}
+
+/*! \fn QImage ThumbnailLoader::fitted(const QImage &image) const
+    \brief Scale an upright picture to fit the thumbnail box.
+
+    \param[in] image the picture.
+    \return the thumbnail, null for a null picture.
+ */
+QImage ThumbnailLoader::fitted(const QImage &image) const
+{
+    if (image.isNull())
+       return image;
+
+    QSize size = image.size().scaled(m_size, Qt::KeepAspectRatio).boundedTo(image.size());
+    if (size.isEmpty())
+       return QImage();
+
+    /* The copy also detaches a bundle slide from the mapping. */
+    return (size == image.size()) ? image.copy() : ImageScaler::scaled(image, size, false);
+}
@@ -0,0 +1,66 @@
+/*! \file  ThumbnailLoader.h
+    \brief Declaration of ThumbnailLoader class.
+ */
+
+#ifndef THUMBNAILLOADER_H
+#define THUMBNAILLOADER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QImage>
+#include <QString>
+#include <QStringList>
+#include <QSize>
+#include <QList>
+
+/*! \class ThumbnailLoader
+    \brief A worker thread making the thumbnails of the slides.
+
+    A thumbnail comes from the slide bundle mapping, else from the EXIF
+    thumbnail of the picture, else from the picture decoded at a fraction of
+    its size, which JPEG does in the DCT domain. The other formats are fully
+    decoded, so setDeferFullDecode() puts them off while the strip is dragged.
+    Only the last requested thumbnails are made, the ones scrolled past are dropped.
+*/
+class ThumbnailLoader : public QThread
+{
+Q_OBJECT
+
+public:
+    ThumbnailLoader(const QSize &size, QObject *parent = 0);  /*!< Constructor */
+    ~ThumbnailLoader();  /*!< Destructor */
+
+    void setFiles(const QStringList &files);  /*!< Make the thumbnails of picture files. */
+    void setBundle(const QString &fileName);  /*!< Make the thumbnails of a slide bundle. */
+    void request(const QList<int> &indices);  /*!< Replace the pending thumbnails, the first is made first. */
+    void setDeferFullDecode(bool defer);  /*!< Skip the pictures which would be fully decoded. */
+
+signals:
+    void thumbnailLoaded(int index, const QImage &thumbnail);
+    void loaded(int index, int generation, const QImage &thumbnail);  /*!< From the worker thread. */
+
+protected:
+    void run();
+
+private slots:
+    void onLoaded(int index, int generation, const QImage &thumbnail);
+
+private:
+    QImage readThumbnail(const QString &fileName, bool deferFullDecode, bool *deferred) const;
+    QImage fitted(const QImage &image) const;
+
+    const QSize m_size;      /*!< The box the thumbnails fit in. */
+
+    QMutex m_mutex;          /*!< Guards the members below shared with the worker. */
+    QWaitCondition m_requested;
+    QStringList m_files;
+    QString m_bundleFile;    /*!< Empty for picture files. */
+    QList<int> m_pending;
+    int m_nBusy;             /*!< The thumbnail being made, -1 for none. */
+    int m_nGeneration;       /*!< Bumped by a new set of slides, older results are dropped. */
+    bool m_bDeferFullDecode; /*!< Skip the pictures without a scaled decode, see setDeferFullDecode(). */
+    bool m_bQuit;
+};
+
+#endif /* THUMBNAILLOADER_H */
@@ -0,0 +1,189 @@
+/*! \file  TileLoader.cpp
+    \brief Implementation of TileLoader class.
+ */
+
+#include <QMutexLocker>
+#include <QtGlobal>
+
+#include "TileLoader.h"
+#include "TilePyramid.h"
+
+/*! \fn TileLoader::TileLoader(const QString &cacheDir, int cacheMBytes, int bufferKBytes, QObject *parent)
+    \brief Constructor, start the worker thread at low priority.
+
+    \param[in] cacheDir the folder of all pyramids.
+    \param[in] cacheMBytes the disk space of all pyramids, the least recently used are removed after a build.
+    \param[in] bufferKBytes the memory for a band of the picture while building.
+    \param[in] parent the parent object.
+ */
+TileLoader::TileLoader(const QString &cacheDir, int cacheMBytes, int bufferKBytes, QObject *parent)
+    : QThread(parent)
+    , m_cacheDir(cacheDir)
+    , m_nCacheMBytes(cacheMBytes)
+    , m_nBufferKBytes(bufferKBytes)
+    , m_nGeneration(0)
+    , m_bQuit(false)
+    , m_abort(0)
+{
+    /* The tiles are read on the worker and shown on the GUI thread. */
+    QObject::connect(this, SIGNAL(ready(int, QSize, int, int)), this, SLOT(onReady(int, QSize, int, int)), Qt::QueuedConnection);
+    QObject::connect(this, SIGNAL(loaded(int, int, int, int, QImage)), this, SLOT(onLoaded(int, int, int, int, QImage)), Qt::QueuedConnection);
+
+    start(QThread::LowPriority);
+}
+
+/*! \fn TileLoader::~TileLoader()
+    \brief Destructor, stop the worker thread, and a pyramid being built.
+ */
+TileLoader::~TileLoader()
+{
+    {
+       QMutexLocker locker(&m_mutex);
+       m_bQuit = true;
+       m_abort.fetchAndStoreOrdered(1);
+       m_requested.wakeAll();
+    }
+
+    wait();
+}
+
+/*! \fn void TileLoader::setImage(const QString &fileName)
+    \brief Read the tiles of a picture, dropping the pending ones of the previous picture.
+
+    \param[in] fileName the picture file, empty for none.
+    \return NONE.
+ */
+void TileLoader::setImage(const QString &fileName)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (fileName == m_fileName)
+       return;
+
+    m_fileName = fileName;
+    m_pending.clear();
+    m_nGeneration++;
+    m_abort.fetchAndStoreOrdered(1);
+    m_requested.wakeOne();
+}
+
+/*! \fn void TileLoader::request(const QList<quint64> &keys)
+    \brief Replace the pending tiles, e.g. with the ones now visible.
+
+    \param[in] keys the tiles as TilePyramid::tileKey(), the most urgent first.
+    \return NONE.
+ */
+void TileLoader::request(const QList<quint64> &keys)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_pending = keys;
+    m_requested.wakeOne();
+}
+
+/*! \fn void TileLoader::onReady(int generation, const QSize &size, int orientation, int levels)
+    \brief Pass on the pyramid opened for the current picture.
+
+    \param[in] generation the picture it was opened for.
+    \param[in] size the size of the picture as stored.
+    \param[in] orientation the EXIF orientation of the picture.
+    \param[in] levels the levels of the pyramid, 0 if it could not be built.
+    \return NONE.
+ */
+void TileLoader::onReady(int generation, const QSize &size, int orientation, int levels)
+{
+    {
+       QMutexLocker locker(&m_mutex);
+       if (generation != m_nGeneration)
+          return;
+    }
+
+    emit pyramidReady(size, orientation, levels);
+}
+
+/*! \fn void TileLoader::onLoaded(int generation, int level, int column, int row, const QImage &tile)
+    \brief Pass on a tile read for the current picture.
+
+    \param[in] generation the picture it was read for.
+    \param[in] level the level of the tile.
+    \param[in] column the column of the tile in its level.
+    \param[in] row the row of the tile in its level.
+    \param[in] tile the tile, null if it could not be read.
+    \return NONE.
+ */
+void TileLoader::onLoaded(int generation, int level, int column, int row, const QImage &tile)
+{
+    {
+       QMutexLocker locker(&m_mutex);
+       if (generation != m_nGeneration)
+          return;
+    }
+
+    emit tileLoaded(level, column, row, tile);
+}
+
+/*! \fn void TileLoader::run()
+    \brief Open or build the pyramid of the current picture, then read its first pending tile, until the loader quits.
+
+    \param[in] NONE.
+    \return NONE.
+ */
+void TileLoader::run()
+{
+    TilePyramid pyramid;
+    QString openFile;  /* The picture of pyramid, tried once even if it failed. */
+
+    forever
+    {
+       int generation;
+       quint64 key = 0;
+       QString fileName;
+       {
+          QMutexLocker locker(&m_mutex);
+
+          while (!m_bQuit && m_fileName == openFile && m_pending.isEmpty())
+             m_requested.wait(&m_mutex);
+
+          if (m_bQuit)
+             return;
+
+          generation = m_nGeneration;
+          fileName = m_fileName;
+          if (fileName == openFile)
+             key = m_pending.takeFirst();
+          else
+             m_abort.fetchAndStoreOrdered(0);
+       }
+
+       if (fileName != openFile)
+       {
+          pyramid = TilePyramid();
+          openFile = fileName;
+
+          if (!fileName.isEmpty() && !pyramid.open(m_cacheDir, fileName))
+          {
+             if (pyramid.build(m_cacheDir, fileName, m_nBufferKBytes, &m_abort))
+             {
+                /* Only a build grows the cache, make room by removing the pyramids used least recently. */
+                TilePyramid::trimCache(m_cacheDir, static_cast<qint64>(m_nCacheMBytes) * 1024 * 1024, fileName);
+             }
+             else if (TilePyramid::isAborted(&m_abort))
+             {
+                openFile.clear();  /* Built again if the picture is opened again. */
+             }
+          }
+
+          emit ready(generation, pyramid.size(), pyramid.orientation(), pyramid.levels());
+          continue;
+       }
+
+       if (!pyramid.isOpen())
+          continue;
+
+       int level = static_cast<int>(key >> 48);
+       int row = static_cast<int>((key >> 24) & 0xFFFFFF);
+       int column = static_cast<int>(key & 0xFFFFFF);
+
+       emit loaded(generation, level, column, row, pyramid.tile(level, column, row));
+    }
+}
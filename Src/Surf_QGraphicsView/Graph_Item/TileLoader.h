@@ -0,0 +1,61 @@
+/*! \file  TileLoader.h
+    \brief Declaration of TileLoader class.
+ */
+
+#ifndef TILELOADER_H
+#define TILELOADER_H
+
+#include <QThread>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QImage>
+#include <QString>
+#include <QSize>
+#include <QList>
+
+/*! \class TileLoader
+    \brief A worker thread reading the tiles of a picture's pyramid, building the pyramid first if it is not cached.
+
+    Only the last requested tiles are read, the ones scrolled or zoomed past
+    are dropped. Opening another picture stops a pyramid being built.
+*/
+class TileLoader : public QThread
+{
+Q_OBJECT
+
+public:
+    TileLoader(const QString &cacheDir, int cacheMBytes, int bufferKBytes, QObject *parent = 0);  /*!< Constructor */
+    ~TileLoader();  /*!< Destructor */
+
+    void setImage(const QString &fileName);  /*!< Read the tiles of a picture, empty for none. */
+    void request(const QList<quint64> &keys);  /*!< Replace the pending tiles, the first is read first. */
+
+signals:
+    void pyramidReady(const QSize &size, int orientation, int levels);  /*!< 0 levels if it could not be built. */
+    void tileLoaded(int level, int column, int row, const QImage &tile);
+    void ready(int generation, const QSize &size, int orientation, int levels);  /*!< From the worker thread. */
+    void loaded(int generation, int level, int column, int row, const QImage &tile);  /*!< From the worker thread. */
+
+protected:
+    void run();
+
+private slots:
+    void onReady(int generation, const QSize &size, int orientation, int levels);
+    void onLoaded(int generation, int level, int column, int row, const QImage &tile);
+
+private:
+    const QString m_cacheDir;   /*!< The folder of all pyramids. */
+    const int m_nCacheMBytes;   /*!< The disk space of all pyramids. */
+    const int m_nBufferKBytes;  /*!< The memory for a band of the picture while building. */
+
+    QMutex m_mutex;             /*!< Guards the members below shared with the worker. */
+    QWaitCondition m_requested;
+    QString m_fileName;
+    QList<quint64> m_pending;
+    int m_nGeneration;          /*!< Bumped by another picture, older results are dropped. */
+    bool m_bQuit;
+    QAtomicInt m_abort;         /*!< Non-zero to stop building, polled without the mutex. */
+};
+
+#endif /* TILELOADER_H */
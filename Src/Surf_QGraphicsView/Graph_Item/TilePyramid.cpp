@@ -0,0 +1,604 @@
+/*! \file  TilePyramid.cpp
+    \brief Implementation of TilePyramid class.
+ */
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QImageReader>
+#include <QMultiMap>
+#include <QPainter>
+#include <QSettings>
+#include <QVector>
+#include <QtGlobal>
+
+#include <limits.h>
+
+#ifdef HAVE_LIBJPEG
+#include <stdio.h>
+#include <setjmp.h>
+extern "C" {
+#include <jpeglib.h>
+}
+#endif
+
+#include "TilePyramid.h"
+#include "ImageScaler.h"
+#include "ExifReader.h"
+
+#define PYRAMID_DIR_NAME_LENGTH 32  /* The hex MD5 naming a pyramid folder, see pyramidDir(). */
+
+#ifdef HAVE_LIBJPEG
+/*! \struct JpegErrorManager
+    \brief The libjpeg error handler jumping back to TilePyramid::buildJpegBase() instead of exiting.
+*/
+struct JpegErrorManager
+{
+    struct jpeg_error_mgr manager;  /*!< First, libjpeg sees only this. */
+    jmp_buf jump;
+};
+
+/*! \fn static void jpegErrorExit(j_common_ptr info)
+    \brief Print the libjpeg error and jump back to the decoding.
+
+    \param[in] info the libjpeg decompressor.
+    \return NONE.
+ */
+static void jpegErrorExit(j_common_ptr info)
+{
+    (*info->err->output_message)(info);
+    longjmp(reinterpret_cast<JpegErrorManager *>(info->err)->jump, 1);
+}
+#endif
+
+/*! \fn static int bandTileRows(int width, int bytesPerPixel, qint64 bufferBytes)
+    \brief Return how many whole tile rows of a picture a buffer holds.
+
+    \param[in] width the width of the picture.
+    \param[in] bytesPerPixel the bytes of a pixel in the buffer.
+    \param[in] bufferBytes the size of the buffer.
+    \return the tile rows, 0 if not even one fits.
+ */
+static int bandTileRows(int width, int bytesPerPixel, qint64 bufferBytes)
+{
+    /* The scanlines of a QImage are 32-bit aligned. */
+    qint64 lineBytes = (static_cast<qint64>(width) * bytesPerPixel + 3) / 4 * 4;
+
+    return static_cast<int>(qMin(static_cast<qint64>(INT_MAX), bufferBytes / (lineBytes * TILE_PYRAMID_TILE_SIZE)));
+}
+
+/*! \fn static void removePyramidDir(const QString &path)
+    \brief Remove a pyramid folder, it holds files only.
+
+    \param[in] path the folder.
+    \return NONE.
+ */
+static void removePyramidDir(const QString &path)
+{
+    QDir dir(path);
+
+    foreach (const QString &file, dir.entryList(QDir::Files | QDir::Hidden))
+       dir.remove(file);
+
+    QDir().rmdir(path);
+}
+
+/*! \fn TilePyramid::TilePyramid()
+    \brief Constructor
+ */
+TilePyramid::TilePyramid()
+    : m_nOrientation(1)
+    , m_nLevels(0)
+{
+}
+
+/*! \fn bool TilePyramid::open(const QString &cacheDir, const QString &fileName)
+    \brief Open the pyramid of a picture built before, a half-built one is not opened.
+
+    \param[in] cacheDir the folder of all pyramids.
+    \param[in] fileName the picture file.
+    \return true if the pyramid is complete.
+ */
+bool TilePyramid::open(const QString &cacheDir, const QString &fileName)
+{
+    m_nLevels = 0;
+    m_dir = pyramidDir(cacheDir, fileName);
+
+    QSettings meta(m_dir + "/" TILE_PYRAMID_META_FILE, QSettings::IniFormat);
+    if (meta.value("Pyramid/Version").toInt() != TILE_PYRAMID_VERSION ||
+        meta.value("Pyramid/TileSize").toInt() != TILE_PYRAMID_TILE_SIZE)
+       return false;
+
+    m_size = QSize(meta.value("Pyramid/Width").toInt(), meta.value("Pyramid/Height").toInt());
+    m_nOrientation = meta.value("Pyramid/Orientation", 1).toInt();
+    m_format = meta.value("Pyramid/Format").toString();
+    m_nLevels = m_size.isEmpty() ? 0 : meta.value("Pyramid/Levels").toInt();
+
+    /* Rewriting the meta file marks the pyramid as used now, see trimCache(). */
+    if (m_nLevels > 0)
+    {
+       meta.setValue("Pyramid/LastOpened", QDateTime::currentDateTime().toString(Qt::ISODate));
+       meta.sync();
+    }
+
+    return m_nLevels > 0;
+}
+
+/*! \fn bool TilePyramid::build(const QString &cacheDir, const QString &fileName, int bufferKBytes, const QAtomicInt *abort)
+    \brief Build the pyramid of a picture into its cache folder, within a bounded memory.
+
+    A JPEG picture is decoded by one reader from top to bottom, into a band
+    of as many whole tile rows as the buffer holds, so it is decoded once
+    whatever the buffer; a smaller buffer only writes fewer tiles at a time.
+    Other pictures are decoded whole, once. A picture the buffer cannot hold
+    one tile row of, or whole for other formats, is refused.
+
+    \param[in] cacheDir the folder of all pyramids.
+    \param[in] fileName the picture file.
+    \param[in] bufferKBytes the memory for the decoded picture, a band of it for JPEG.
+    \param[in] abort set by another thread to stop building.
+    \return true if the pyramid is complete.
+ */
+bool TilePyramid::build(const QString &cacheDir, const QString &fileName, int bufferKBytes, const QAtomicInt *abort)
+{
+    m_nLevels = 0;
+    m_format.clear();
+    m_dir = pyramidDir(cacheDir, fileName);
+
+    /* The meta file marks a complete pyramid, it is written last. */
+    if (!QDir().mkpath(m_dir))
+       return false;
+    QFile::remove(m_dir + "/" TILE_PYRAMID_META_FILE);
+
+    QImageReader probe(fileName);
+    m_size = probe.size();
+    if (m_size.isEmpty())
+       return false;
+
+    m_nOrientation = ExifReader(fileName).orientation();
+
+    int levels = 1;
+    while (qMax(levelSize(levels - 1).width(), levelSize(levels - 1).height()) > TILE_PYRAMID_TILE_SIZE)
+       levels++;
+
+    qint64 bufferBytes = static_cast<qint64>(bufferKBytes) * 1024;
+    BaseResult base = BASE_UNSUPPORTED;
+
+    if (probe.format() == "jpeg")
+       base = buildJpegBase(fileName, bufferBytes, abort);
+
+    if (base == BASE_UNSUPPORTED && !isAborted(abort))
+       base = buildImageBase(fileName, bufferBytes);
+
+    if (base != BASE_BUILT)
+       return false;
+
+    m_nLevels = levels;
+    for (int level = 1; level < levels; level++)
+    {
+       if (!buildLevel(level, abort))
+       {
+          m_nLevels = 0;
+          return false;
+       }
+    }
+
+    QSettings meta(m_dir + "/" TILE_PYRAMID_META_FILE, QSettings::IniFormat);
+    meta.setValue("Pyramid/Source", QFileInfo(fileName).absoluteFilePath());
+    meta.setValue("Pyramid/Width", m_size.width());
+    meta.setValue("Pyramid/Height", m_size.height());
+    meta.setValue("Pyramid/Orientation", m_nOrientation);
+    meta.setValue("Pyramid/Levels", m_nLevels);
+    meta.setValue("Pyramid/Format", m_format);
+    meta.setValue("Pyramid/TileSize", TILE_PYRAMID_TILE_SIZE);
+    meta.setValue("Pyramid/Version", TILE_PYRAMID_VERSION);
+    meta.sync();
+
+    return meta.status() == QSettings::NoError;
+}
+
+/*! \fn TilePyramid::BaseResult TilePyramid::buildJpegBase(const QString &fileName, qint64 bufferBytes, const QAtomicInt *abort)
+    \brief Build level 0 of a JPEG picture, decoding its scanlines once from top to bottom.
+
+    The band is the only copy of the picture in memory: as many whole tile
+    rows as fit the buffer are decoded into it, cut into tiles, and the
+    next rows are decoded over them.
+
+    \param[in] fileName the picture file.
+    \param[in] bufferBytes the memory for the band.
+    \param[in] abort set by another thread to stop building.
+    \return BASE_UNSUPPORTED without libjpeg or for a CMYK picture.
+ */
+TilePyramid::BaseResult TilePyramid::buildJpegBase(const QString &fileName, qint64 bufferBytes, const QAtomicInt *abort)
+{
+#ifdef HAVE_LIBJPEG
+    FILE *file = fopen(QFile::encodeName(fileName).constData(), "rb");
+    if (file == NULL)
+       return BASE_FAILED;
+
+    /* Only these live across the jump of an error, nothing else with a destructor may. */
+    struct jpeg_decompress_struct info;
+    JpegErrorManager error;
+    QImage band;
+
+    info.err = jpeg_std_error(&error.manager);
+    error.manager.error_exit = jpegErrorExit;
+
+    if (setjmp(error.jump))
+    {
+       qDebug("%s : %s(%d) - %s: broken JPEG", __FILE__, __FUNCTION__, __LINE__, qPrintable(fileName));
+
+       jpeg_destroy_decompress(&info);
+       fclose(file);
+       return BASE_FAILED;
+    }
+
+    jpeg_create_decompress(&info);
+    jpeg_stdio_src(&info, file);
+    jpeg_read_header(&info, TRUE);
+
+    /* Qt inverts Adobe CMYK itself, leave those to buildImageBase(). */
+    if (info.jpeg_color_space == JCS_CMYK || info.jpeg_color_space == JCS_YCCK)
+    {
+       jpeg_destroy_decompress(&info);
+       fclose(file);
+       return BASE_UNSUPPORTED;
+    }
+
+    bool gray = (info.jpeg_color_space == JCS_GRAYSCALE);
+    info.out_color_space = gray ? JCS_GRAYSCALE : JCS_RGB;
+    jpeg_start_decompress(&info);
+
+    int width = static_cast<int>(info.output_width);
+    int height = static_cast<int>(info.output_height);
+    int bandRows = bandTileRows(width, gray ? 1 : 3, bufferBytes) * TILE_PYRAMID_TILE_SIZE;
+
+    if (width != m_size.width() || height != m_size.height() || bandRows <= 0)
+    {
+       qDebug("%s : %s(%d) - %s: %dx%d, a tile row does not fit a buffer of %lld KB", __FILE__, __FUNCTION__, __LINE__,
+              qPrintable(fileName), width, height, bufferBytes / 1024);
+
+       jpeg_destroy_decompress(&info);
+       fclose(file);
+       return BASE_FAILED;
+    }
+
+    band = QImage(width, qMin(bandRows, height), gray ? QImage::Format_Indexed8 : QImage::Format_RGB888);
+    if (gray)
+    {
+       QVector<QRgb> grays(256);
+       for (int i = 0; i < grays.count(); i++)
+          grays[i] = qRgb(i, i, i);
+       band.setColorTable(grays);
+    }
+
+    m_format = "jpg";
+
+    BaseResult result = BASE_BUILT;
+    for (int top = 0; top < height && result == BASE_BUILT; top += bandRows)
+    {
+       if (isAborted(abort))
+       {
+          result = BASE_FAILED;
+          break;
+       }
+
+       int rows = qMin(bandRows, height - top);
+       for (int y = 0; y < rows; )
+       {
+          JSAMPROW line = band.scanLine(y);
+          y += jpeg_read_scanlines(&info, &line, 1);
+       }
+
+       if (!saveBand(band, top, rows))
+          result = BASE_FAILED;
+    }
+
+    if (result == BASE_BUILT)
+       jpeg_finish_decompress(&info);
+
+    jpeg_destroy_decompress(&info);
+    fclose(file);
+
+    return result;
+#else
+    Q_UNUSED(fileName);
+    Q_UNUSED(bufferBytes);
+    Q_UNUSED(abort);
+
+    return BASE_UNSUPPORTED;
+#endif
+}
+
+/*! \fn TilePyramid::BaseResult TilePyramid::buildImageBase(const QString &fileName, qint64 bufferBytes)
+    \brief Build level 0 of a picture decoded whole, once, by Qt.
+
+    \param[in] fileName the picture file.
+    \param[in] bufferBytes the memory for the decoded picture.
+    \return BASE_FAILED if the picture does not fit the buffer or cannot be read.
+ */
+TilePyramid::BaseResult TilePyramid::buildImageBase(const QString &fileName, qint64 bufferBytes)
+{
+    /* Decoded to 32 bits per pixel at most. */
+    if (bandTileRows(m_size.width(), 4, bufferBytes) * TILE_PYRAMID_TILE_SIZE < m_size.height())
+    {
+       qDebug("%s : %s(%d) - %s: %dx%d does not fit a buffer of %lld KB", __FILE__, __FUNCTION__, __LINE__,
+              qPrintable(fileName), m_size.width(), m_size.height(), bufferBytes / 1024);
+       return BASE_FAILED;
+    }
+
+    QImageReader reader(fileName);
+
+    #if QT_VERSION >= 0x050500
+    reader.setAutoTransform(false);  /* The tiles are stored as the picture is, see orientation(). */
+    #endif
+
+    QImage image = reader.read();
+    if (image.size() != m_size)
+    {
+       qDebug("%s : %s(%d) - %s: %s", __FILE__, __FUNCTION__, __LINE__,
+              qPrintable(fileName), qPrintable(reader.errorString()));
+       return BASE_FAILED;
+    }
+
+    m_format = image.hasAlphaChannel() ? "png" : "jpg";
+
+    return saveBand(image, 0, image.height()) ? BASE_BUILT : BASE_FAILED;
+}
+
+/*! \fn bool TilePyramid::saveBand(const QImage &band, int top, int rows)
+    \brief Cut the first rows of a band of the picture into level 0 tiles.
+
+    \param[in] band the band, as wide as the picture.
+    \param[in] top the row of the picture at the top of the band, on a tile boundary.
+    \param[in] rows the rows of the band holding the picture.
+    \return true if all tiles were written.
+ */
+bool TilePyramid::saveBand(const QImage &band, int top, int rows)
+{
+    const int edge = TILE_PYRAMID_TILE_SIZE;
+
+    for (int ty = 0; ty < rows; ty += edge)
+    {
+       for (int tx = 0; tx < band.width(); tx += edge)
+       {
+          QImage piece = band.copy(tx, ty, qMin(edge, band.width() - tx), qMin(edge, rows - ty));
+          if (!piece.save(tileFile(0, tx / edge, (top + ty) / edge), 0, (m_format == "jpg") ? TILE_JPEG_QUALITY : -1))
+             return false;
+       }
+    }
+
+    return true;
+}
+
+/*! \fn bool TilePyramid::buildLevel(int level, const QAtomicInt *abort)
+    \brief Build a level by halving each 2x2 block of tiles of the level below it.
+
+    \param[in] level the level to build, from 1.
+    \param[in] abort set by another thread to stop building.
+    \return true if all tiles were written.
+ */
+bool TilePyramid::buildLevel(int level, const QAtomicInt *abort)
+{
+    const int edge = TILE_PYRAMID_TILE_SIZE;
+    QSize below = levelSize(level - 1);
+    QSize size = levelSize(level);
+    bool alpha = (m_format == "png");
+
+    for (int row = 0; row * edge < size.height(); row++)
+    {
+       for (int column = 0; column * edge < size.width(); column++)
+       {
+          if (isAborted(abort))
+             return false;
+
+          QImage block(qMin(2 * edge, below.width() - 2 * column * edge), qMin(2 * edge, below.height() - 2 * row * edge),
+                       alpha ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32);
+          block.fill(0);
+
+          QPainter painter(&block);
+          for (int dy = 0; dy < 2; dy++)
+          {
+             for (int dx = 0; dx < 2; dx++)
+             {
+                QImage piece = tile(level - 1, 2 * column + dx, 2 * row + dy);
+                if (!piece.isNull())
+                   painter.drawImage(dx * edge, dy * edge, piece);
+             }
+          }
+          painter.end();
+
+          /* Rounded up, as levelSize() is. */
+          QSize half((block.width() + 1) / 2, (block.height() + 1) / 2);
+          if (!ImageScaler::scaled(block, half, false).save(tileFile(level, column, row), 0, alpha ? -1 : TILE_JPEG_QUALITY))
+             return false;
+       }
+    }
+
+    return true;
+}
+
+/*! \fn bool TilePyramid::isOpen() const
+    \brief Check if the pyramid is complete and can be read.
+
+    \param[in] NONE.
+    \return true if it is open.
+ */
+bool TilePyramid::isOpen() const
+{
+    return m_nLevels > 0;
+}
+
+/*! \fn QSize TilePyramid::size() const
+    \brief Return the size of the picture as stored, before turning it upright.
+
+    \param[in] NONE.
+    \return the size of level 0.
+ */
+QSize TilePyramid::size() const
+{
+    return m_size;
+}
+
+/*! \fn int TilePyramid::orientation() const
+    \brief Return the EXIF orientation of the picture, the tiles are not turned upright.
+
+    \param[in] NONE.
+    \return the orientation, 1 (upright) to 8.
+ */
+int TilePyramid::orientation() const
+{
+    return m_nOrientation;
+}
+
+/*! \fn int TilePyramid::levels() const
+    \brief Return the number of levels, the last one fits in one tile.
+
+    \param[in] NONE.
+    \return the levels, 0 when not open.
+ */
+int TilePyramid::levels() const
+{
+    return m_nLevels;
+}
+
+/*! \fn QSize TilePyramid::levelSize(int level) const
+    \brief Return the size of the picture at a level, halved and rounded up per level.
+
+    \param[in] level the level, 0 for full resolution.
+    \return the size of the level.
+ */
+QSize TilePyramid::levelSize(int level) const
+{
+    int scale = 1 << level;
+
+    return QSize((m_size.width() + scale - 1) / scale, (m_size.height() + scale - 1) / scale);
+}
+
+/*! \fn QImage TilePyramid::tile(int level, int column, int row) const
+    \brief Read a tile from the cache folder.
+
+    \param[in] level the level of the tile.
+    \param[in] column the column of the tile in its level.
+    \param[in] row the row of the tile in its level.
+    \return the tile, null if it is not there.
+ */
+QImage TilePyramid::tile(int level, int column, int row) const
+{
+    return QImage(tileFile(level, column, row));
+}
+
+/*! \fn quint64 TilePyramid::tileKey(int level, int column, int row)
+    \brief Pack a tile into one number, 24 bits per position are 4 billion pixels at 256.
+
+    \param[in] level the level of the tile.
+    \param[in] column the column of the tile in its level.
+    \param[in] row the row of the tile in its level.
+    \return the key of the tile.
+ */
+quint64 TilePyramid::tileKey(int level, int column, int row)
+{
+    return (static_cast<quint64>(level) << 48) | (static_cast<quint64>(row & 0xFFFFFF) << 24) | static_cast<quint64>(column & 0xFFFFFF);
+}
+
+/*! \fn bool TilePyramid::isAborted(const QAtomicInt *abort)
+    \brief Return whether another thread stopped the building.
+
+    \param[in] abort the flag passed to build(), set to non-zero to stop.
+    \return true to stop building.
+ */
+bool TilePyramid::isAborted(const QAtomicInt *abort)
+{
+#if QT_VERSION >= 0x050000
+    return abort->load() != 0;
+#else
+    return *abort != 0;
+#endif
+}
+
+/*! \fn void TilePyramid::trimCache(const QString &cacheDir, qint64 maxBytes, const QString &keepFile)
+    \brief Remove the least recently used pyramids until the cache fits its disk space.
+
+    The pyramids are ordered by the time stamp of their meta file, written
+    when a pyramid is built or opened. A folder without a meta file is a
+    pyramid stopped half-built and is removed whatever the space.
+
+    \param[in] cacheDir the folder of all pyramids.
+    \param[in] maxBytes the disk space of all pyramids.
+    \param[in] keepFile the picture whose pyramid is kept, e.g. the one just built.
+    \return NONE.
+ */
+void TilePyramid::trimCache(const QString &cacheDir, qint64 maxBytes, const QString &keepFile)
+{
+    const QString keep = QDir(pyramidDir(cacheDir, keepFile)).absolutePath();
+    QMultiMap<QDateTime, QString> byAge;  /* The complete pyramids, least recently used first. */
+    QHash<QString, qint64> sizes;
+    qint64 total = 0;
+
+    foreach (const QFileInfo &entry, QDir(cacheDir).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot))
+    {
+       /* Only the folders named by pyramidDir() are pyramids. */
+       if (entry.fileName().length() != PYRAMID_DIR_NAME_LENGTH)
+          continue;
+
+       QString path = entry.absoluteFilePath();
+       QFileInfo meta(path + "/" TILE_PYRAMID_META_FILE);
+
+       qint64 bytes = 0;
+       foreach (const QFileInfo &file, QDir(path).entryInfoList(QDir::Files))
+          bytes += file.size();
+
+       if (path == keep)
+       {
+          total += bytes;
+       }
+       else if (!meta.exists())
+       {
+          removePyramidDir(path);
+       }
+       else
+       {
+          total += bytes;
+          sizes.insert(path, bytes);
+          byAge.insert(meta.lastModified(), path);
+       }
+    }
+
+    for (QMultiMap<QDateTime, QString>::const_iterator it = byAge.constBegin(); it != byAge.constEnd() && total > maxBytes; ++it)
+    {
+       removePyramidDir(it.value());
+       total -= sizes.value(it.value());
+    }
+}
+
+/*! \fn QString TilePyramid::pyramidDir(const QString &cacheDir, const QString &fileName)
+    \brief Return the cache folder of a picture, a changed file gets another one.
+
+    \param[in] cacheDir the folder of all pyramids.
+    \param[in] fileName the picture file.
+    \return the folder of its pyramid.
+ */
+QString TilePyramid::pyramidDir(const QString &cacheDir, const QString &fileName)
+{
+    QFileInfo info(fileName);
+    QString identity = QString("%1|%2|%3").arg(info.absoluteFilePath()).arg(info.size())
+                                          .arg(info.lastModified().toString(Qt::ISODate));
+
+    return cacheDir + "/" + QCryptographicHash::hash(identity.toUtf8(), QCryptographicHash::Md5).toHex();
+}
+
+/*! \fn QString TilePyramid::tileFile(int level, int column, int row) const
+    \brief Return the file of a tile.
+
+    \param[in] level the level of the tile.
+    \param[in] column the column of the tile in its level.
+    \param[in] row the row of the tile in its level.
+    \return the file name.
+ */
+QString TilePyramid::tileFile(int level, int column, int row) const
+{
+    return QString("%1/%2_%3_%4.%5").arg(m_dir).arg(level).arg(column).arg(row).arg(m_format);
+}
@@ -0,0 +1,78 @@
+/*! \file  TilePyramid.h
+    \brief Declaration of TilePyramid class.
+ */
+
+#ifndef TILEPYRAMID_H
+#define TILEPYRAMID_H
+
+#include <QAtomicInt>
+#include <QImage>
+#include <QSize>
+#include <QString>
+
+/* The layout of a pyramid in its cache folder:
+     pyramid.ini                the size, levels and tile format, written last
+     <level>_<column>_<row>.jpg the tiles, level 0 at full resolution, each
+                                level half the size of the one below it. */
+#define TILE_PYRAMID_TILE_SIZE   256
+#define TILE_PYRAMID_META_FILE   "pyramid.ini"
+#define TILE_PYRAMID_VERSION     1
+#define TILE_JPEG_QUALITY        90
+
+/*! \class TilePyramid
+    \brief The multi-resolution tiles of a picture, cached on disk for viewing it at any zoom.
+
+    The pyramid is built once per picture, identified by its path, size and
+    time stamp. Opening it touches its meta file, so the time stamps of the
+    meta files tell the least recently used pyramids, see trimCache().
+
+    Built with libjpeg (qmake CONFIG+=libjpeg), level 0 of a JPEG picture is
+    decoded in one pass from top to bottom, a band of whole tile rows at a
+    time, so only a band is held in memory. Otherwise the pictures are
+    decoded whole once by QImageReader, if they fit the buffer. Each upper
+    level is halved from four tiles of the level below it.
+*/
+class TilePyramid
+{
+public:
+    TilePyramid();  /*!< Constructor */
+
+    bool open(const QString &cacheDir, const QString &fileName);  /*!< Open the cached pyramid of a picture. */
+    bool build(const QString &cacheDir, const QString &fileName, int bufferKBytes, const QAtomicInt *abort);  /*!< Build and cache it. */
+    bool isOpen() const;
+
+    QSize size() const;        /*!< The size of the picture as stored, not turned upright. */
+    int orientation() const;   /*!< The EXIF orientation of the picture. */
+    int levels() const;
+    QSize levelSize(int level) const;
+    QImage tile(int level, int column, int row) const;  /*!< Read a tile, null if it is not there. */
+
+    static quint64 tileKey(int level, int column, int row);  /*!< A tile as one number, for hashing. */
+    static void trimCache(const QString &cacheDir, qint64 maxBytes, const QString &keepFile);  /*!< Remove the least recently used pyramids. */
+    static bool isAborted(const QAtomicInt *abort);  /*!< Whether another thread stopped the building. */
+
+private:
+    /*! \enum BaseResult
+        \brief How building level 0 ended.
+    */
+    enum BaseResult{
+        BASE_BUILT = 0,   /*!< All tiles of level 0 were written. */
+        BASE_FAILED,      /*!< The picture could not be read, or the tiles written. */
+        BASE_UNSUPPORTED  /*!< The decoder cannot read this picture, another one may. */
+    };
+
+    static QString pyramidDir(const QString &cacheDir, const QString &fileName);
+    QString tileFile(int level, int column, int row) const;
+    BaseResult buildJpegBase(const QString &fileName, qint64 bufferBytes, const QAtomicInt *abort);
+    BaseResult buildImageBase(const QString &fileName, qint64 bufferBytes);
+    bool saveBand(const QImage &band, int top, int rows);
+    bool buildLevel(int level, const QAtomicInt *abort);
+
+    QString m_dir;       /*!< The cache folder of this picture. */
+    QSize m_size;
+    int m_nOrientation;
+    int m_nLevels;       /*!< 0 when not open. */
+    QString m_format;    /*!< "jpg", or "png" for a picture with alpha. */
+};
+
+#endif /* TILEPYRAMID_H */
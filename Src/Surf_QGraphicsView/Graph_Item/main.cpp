@@ -12,13 +12,100 @@
 
 #include <QtGlobal>  // Added for Qt5, 2015-09-10.
 #include <QApplication>
+#include <QStringList>
+#include <QImage>
 
 #include "SlidingWindow.h"
+#include "SlideBenchmark.h"
+#include "ImageScaler.h"
 
 /* The initial position of sliding window. */
 #define START_POS_X 120
 #define START_POS_Y  25
 
+/* The size and runs of "-benchscale <image>", fitting an image to the default window. */
+#define BENCH_SCALE_WIDTH  1024
+#define BENCH_SCALE_HEIGHT  600
+#define BENCH_SCALE_RUNS     10
+
+/* The sweeps of "-benchslide", see SlidingWindow::startBenchmark(). */
+#define BENCH_SLIDE_SWEEPS 3
+
+/*! \fn int parseOptions(const QStringList &args, int options)
+    \brief Switch the features of the sliding window on/off from the command line,
+           e.g. "-controlpanel" switches it on and "-nocontrolpanel" switches it off.
+
+    \param[in] args the command line arguments.
+    \param[in] options the default features.
+    \return the features to create the sliding window with.
+ */
+static int parseOptions(const QStringList &args, int options)
+{
+    static const struct { const char *name; SlidingWindowOption option; } switches[] = {
+        { "transparent", SW_TRANSPARENT_FRAME },
+        { "pagenum", SW_PAGE_NUM },
+        { "controlpanel", SW_CONTROL_PANEL },
+        { "tilecompositor", SW_TILE_COMPOSITOR },
+        { "scrubber", SW_THUMB_SCRUBBER },
+        { "deepzoom", SW_DEEP_ZOOM }
+    };
+
+    for (unsigned int i = 0; i < sizeof(switches) / sizeof(switches[0]); i++)
+    {
+        if (args.contains(QString("-%1").arg(switches[i].name)))
+           options |= switches[i].option;
+        else if (args.contains(QString("-no%1").arg(switches[i].name)))
+           options &= ~switches[i].option;
+    }
+
+    return options;
+}
+
+/*! \fn QList<BenchmarkConfig> parseBenchmarkConfigs(const QString &list, int options)
+    \brief Read the configurations of "-benchslide", e.g. "lowpower,quality:notransparent".
+
+    Each configuration is a rendering profile and/or the switches of
+    parseOptions() without their "-", separated by ':'. A configuration
+    without a profile uses the one of the layout file.
+
+    \param[in] list the configurations separated by ',', empty for the configured one only.
+    \param[in] options the features of the command line, switched by each configuration.
+    \return the configurations.
+ */
+static QList<BenchmarkConfig> parseBenchmarkConfigs(const QString &list, int options)
+{
+    QList<BenchmarkConfig> configs;
+
+    foreach (const QString &name, list.split(','))
+    {
+        if (name.isEmpty() && !list.isEmpty())
+           continue;
+
+        QStringList parts = name.split(':');
+        BenchmarkConfig config;
+        bool ok = false;
+
+        config.profile = SlidingWindow::renderProfileFromName(parts.first(), &ok);
+        if (ok)
+           parts.removeFirst();
+        else
+           config.profile = -1;
+
+        QStringList switches;
+        foreach (const QString &part, parts)
+        {
+            if (!part.isEmpty())
+               switches << QString("-%1").arg(part);
+        }
+
+        config.options = parseOptions(switches, options);
+        config.name = name;
+        configs << config;
+    }
+
+    return configs;
+}
+
 int main(int argc, char *argv[])
 {
     /* Changed for Qt5, 2015-09-10
@@ -37,8 +124,35 @@ int main(int argc, char *argv[])
     app.setApplicationName("Sliding Window");
     app.setApplicationVersion("1.0");
 
+    /* Time the image scalers instead of showing the window. */
+    int benchIndex = app.arguments().indexOf("-benchscale");
+    if (benchIndex >= 0 && benchIndex + 1 < app.arguments().count())
+    {
+       QImage image(app.arguments().at(benchIndex + 1));
+       if (image.isNull())
+          return 1;
+
+       ImageScaler::benchmark(image, image.size().boundedTo(QSize(BENCH_SCALE_WIDTH, BENCH_SCALE_HEIGHT)), BENCH_SCALE_RUNS);
+       return 0;
+    }
+
+    /* "-benchslide [<configurations>]" slides through all pictures and back once per configuration,
+       each in a new window, prints the painting times and quits, see parseBenchmarkConfigs(). */
+    int benchSlideIndex = app.arguments().indexOf("-benchslide");
+    if (benchSlideIndex >= 0)
+    {
+       QString list = app.arguments().value(benchSlideIndex + 1);
+       if (list.startsWith("-"))
+          list.clear();
+
+       SlideBenchmark benchmark(parseBenchmarkConfigs(list, parseOptions(app.arguments(), DFLT_SLIDING_WINDOW_OPTIONS)),
+                                BENCH_SLIDE_SWEEPS, QPoint(START_POS_X, START_POS_Y));
+       benchmark.start();
+       return app.exec();
+    }
+
     /* Create a sliding-window object. */
-    SlidingWindow *slidingWindow = new SlidingWindow();
+    SlidingWindow *slidingWindow = new SlidingWindow(parseOptions(app.arguments(), DFLT_SLIDING_WINDOW_OPTIONS));
 
     /* Let QGraphicsView object be visible */
     //slidingWindow->showFullScreen();
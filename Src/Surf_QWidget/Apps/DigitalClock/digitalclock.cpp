@@ -45,7 +45,7 @@
 
 //! [0]
 DigitalClock::DigitalClock(QWidget *parent)
-    : QLCDNumber(parent)
+    : QLCDNumber(parent), colonVisible(false), renderingFaces(false)
 {
     setSegmentStyle(Filled);
 
@@ -66,8 +66,86 @@ void DigitalClock::showTime()
 {
     QTime time = QTime::currentTime();
     QString text = time.toString("hh:mm");
-    if ((time.second() % 2) == 0)
-        text[2] = ' ';
-    display(text);
+    bool colon = (time.second() % 2) != 0;
+
+    /* A new minute needs the whole face redrawn; within a minute only the
+       colon blinks, so just its cell is repainted from the cached faces. */
+    if (text != minuteText) {
+        minuteText = text;
+        colonVisible = colon;
+        renderFaces();
+        update();
+    } else if (colon != colonVisible) {
+        colonVisible = colon;
+        update(colonRect);
+    }
 }
 //! [2]
+
+/* Render the face of the current minute once with the colon hidden and once
+   with it shown. The cell where they differ is the one the blink repaints. */
+void DigitalClock::renderFaces()
+{
+    QString hiddenText = minuteText;
+    hiddenText[2] = ' ';
+
+    if (size().isEmpty()) {
+        faces[0] = faces[1] = QPixmap();
+        colonRect = QRect();
+        display(colonVisible ? minuteText : hiddenText);
+        return;
+    }
+
+    renderingFaces = true;
+    for (int i = 0; i < 2; ++i) {
+        display(i ? minuteText : hiddenText);
+        faces[i] = QPixmap(size());
+        faces[i].fill(Qt::transparent);
+        render(&faces[i]);
+    }
+    display(colonVisible ? minuteText : hiddenText);
+    renderingFaces = false;
+
+    QImage hidden = faces[0].toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    QImage shown = faces[1].toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    int left = hidden.width(), top = hidden.height(), right = -1, bottom = -1;
+    for (int y = 0; y < hidden.height(); ++y) {
+        const QRgb *a = reinterpret_cast<const QRgb *>(hidden.constScanLine(y));
+        const QRgb *b = reinterpret_cast<const QRgb *>(shown.constScanLine(y));
+        for (int x = 0; x < hidden.width(); ++x) {
+            if (a[x] != b[x]) {
+                left = qMin(left, x);
+                right = qMax(right, x);
+                top = qMin(top, y);
+                bottom = qMax(bottom, y);
+            }
+        }
+    }
+    colonRect = (right < 0) ? QRect() : QRect(QPoint(left, top), QPoint(right, bottom));
+}
+
+void DigitalClock::paintEvent(QPaintEvent *event)
+{
+    if (renderingFaces || faces[colonVisible].isNull()) {
+        QLCDNumber::paintEvent(event);
+        return;
+    }
+
+    QPainter painter(this);
+    painter.drawPixmap(event->rect(), faces[colonVisible], event->rect());
+}
+
+void DigitalClock::resizeEvent(QResizeEvent *event)
+{
+    QLCDNumber::resizeEvent(event);
+    if (!minuteText.isEmpty())
+        renderFaces();
+}
+
+void DigitalClock::changeEvent(QEvent *event)
+{
+    QLCDNumber::changeEvent(event);
+    if (!minuteText.isEmpty() && (event->type() == QEvent::PaletteChange
+                                  || event->type() == QEvent::StyleChange))
+        renderFaces();
+}
@@ -43,6 +43,7 @@
 #define DIGITALCLOCK_H
 
 #include <QLCDNumber>
+#include <QPixmap>
 
 //! [0]
 class DigitalClock : public QLCDNumber
@@ -52,8 +53,22 @@ class DigitalClock : public QLCDNumber
 public:
     DigitalClock(QWidget *parent = 0);
 
+protected:
+    void paintEvent(QPaintEvent *event);
+    void resizeEvent(QResizeEvent *event);
+    void changeEvent(QEvent *event);
+
 private slots:
     void showTime();
+
+private:
+    void renderFaces();
+
+    QString minuteText;  /* "hh:mm" of the minute currently on the faces. */
+    bool colonVisible;
+    QPixmap faces[2];    /* The clock face with the colon hidden [0] and shown [1]. */
+    QRect colonRect;     /* The part of the face that differs between the two. */
+    bool renderingFaces;
 };
 //! [0]
 
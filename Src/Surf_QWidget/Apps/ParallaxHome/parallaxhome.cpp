@@ -26,8 +26,26 @@
 #define ICON_SIZE 50
 #define ICON_PAD 4
 
+/* Rasterize an SVG icon once per pixel size; the scene then only blits it. */
+static QPixmap iconPixmap(const QString &fname, int dim)
+{
+    QString key = QString("navibar:%1:%2").arg(fname).arg(dim);
+    QPixmap pixmap;
+    if (!QPixmapCache::find(key, &pixmap)) {
+        pixmap = QPixmap(dim, dim);
+        pixmap.fill(Qt::transparent);
+        QPainter painter(&pixmap);
+        QSvgRenderer renderer(fname);
+        renderer.render(&painter);
+        painter.end();
+        QPixmapCache::insert(key, pixmap);
+    }
+    return pixmap;
+}
+
 NaviBar::NaviBar()
         : QGraphicsRectItem()
+        , m_currentIcon(-1)
 {
     setRect(0, 0, 5 * ICON_SIZE, ICON_SIZE);
     setPen(Qt::NoPen);
@@ -38,12 +56,10 @@ NaviBar::NaviBar()
         QString fname = names[i];
         fname.prepend(":/icons/");
         fname.append("-page.svg");
-        QGraphicsSvgItem *icon = new QGraphicsSvgItem(fname);
-        icon->setParentItem(this);
         const int dim = ICON_SIZE - ICON_PAD * 2;
-        qreal sw = dim / icon->boundingRect().width();
-        qreal sh = dim / icon->boundingRect().height();
-        icon->setTransform(QTransform().scale(sw, sh));
+        QGraphicsPixmapItem *icon = new QGraphicsPixmapItem(iconPixmap(fname, dim));
+        icon->setParentItem(this);
+        icon->setPos(i * ICON_SIZE + ICON_PAD, ICON_PAD * 2);
         icon->setZValue(2);
         m_icons << icon;
     }
@@ -60,11 +76,17 @@ NaviBar::NaviBar()
 void NaviBar::setPageOffset(qreal ofs)
 {
     m_cursor->setPos(ofs * ICON_SIZE, 0);
-    for (int i = 0; i < m_icons.count(); ++i) {
-        int y = (i == static_cast<int>(ofs + 0.5)) ? ICON_PAD : ICON_PAD * 2;
-        m_icons[i]->setPos(i * ICON_SIZE + ICON_PAD, y);
-        m_icons[i]->setOpacity(1);
-    }
+
+    /* Only the icon losing and the icon gaining the cursor move. */
+    int current = static_cast<int>(ofs + 0.5);
+    if (current == m_currentIcon)
+        return;
+
+    if (m_currentIcon >= 0 && m_currentIcon < m_icons.count())
+        m_icons[m_currentIcon]->setPos(m_currentIcon * ICON_SIZE + ICON_PAD, ICON_PAD * 2);
+    if (current >= 0 && current < m_icons.count())
+        m_icons[current]->setPos(current * ICON_SIZE + ICON_PAD, ICON_PAD);
+    m_currentIcon = current;
 }
 
 void NaviBar::mousePressEvent(QGraphicsSceneMouseEvent *event)
@@ -76,9 +98,120 @@ void NaviBar::mousePressEvent(QGraphicsSceneMouseEvent *event)
 void NaviBar::paint(QPainter * painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
     widget = widget;
+
+    /* Views may skip saving the painter state around items (DontSavePainterState). */
+    painter->save();
     painter->setBrush(Qt::white);
     painter->setOpacity(0.2);
     painter->drawRect(option->rect.adjusted(-20, ICON_PAD, 20, 0));
+    painter->restore();
+}
+
+
+/* Wallpaper implementations. */
+
+/* The tiles kept resident on each side of the viewport, ready before they scroll in. */
+#define WALLPAPER_MARGIN_TILES 1
+
+Wallpaper::Wallpaper(const QString &fileName)
+        : QGraphicsItem()
+        , m_tileWidth(0)
+{
+    /* Decoded here once, so moving the wallpaper never decodes; the
+       wallpaper has no alpha, so RGB32 pixmaps are blitted, not blended. */
+    m_image = QImage(fileName).convertToFormat(QImage::Format_RGB32);
+    m_size = m_image.size();
+    m_tileWidth = m_size.width();
+
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+}
+
+void Wallpaper::setTileWidth(int tileWidth)
+{
+    if (tileWidth <= 0 || tileWidth == m_tileWidth || m_size.isEmpty())
+        return;
+
+    m_tileWidth = tileWidth;
+    m_resident.clear();
+    update();
+}
+
+/* A tile of the decoded wallpaper, sharing its pixels rather than copying them. */
+QImage Wallpaper::tile(int index) const
+{
+    const int left = index * m_tileWidth;
+    const int width = qMin(m_tileWidth, m_size.width() - left);
+
+    return QImage(m_image.constBits() + left * 4, width, m_size.height(), m_image.bytesPerLine(), QImage::Format_RGB32);
+}
+
+/* Make the pixmaps of the tiles within the margin of the visible area (in
+   wallpaper coordinates) and release the others. Called when the wallpaper
+   moves, so paint() only blits pixmaps that already exist. */
+void Wallpaper::prepare(const QRectF &visible)
+{
+    if (m_size.isEmpty() || m_tileWidth <= 0)
+        return;
+
+    const int lastTile = (m_size.width() - 1) / m_tileWidth;
+    const int first = qBound(0, static_cast<int>(qMax(qreal(0), visible.left())) / m_tileWidth - WALLPAPER_MARGIN_TILES, lastTile);
+    const int last = qBound(0, static_cast<int>(qMax(qreal(0), visible.right())) / m_tileWidth + WALLPAPER_MARGIN_TILES, lastTile);
+
+    foreach (int i, m_resident.keys()) {
+        if (i < first || i > last)
+            m_resident.remove(i);
+    }
+
+    for (int i = first; i <= last; ++i) {
+        if (!m_resident.contains(i))
+            m_resident.insert(i, QPixmap::fromImage(tile(i)));
+    }
+}
+
+QRectF Wallpaper::boundingRect() const
+{
+    return QRectF(QPointF(0, 0), m_size);
+}
+
+QPainterPath Wallpaper::opaqueArea() const
+{
+    QPainterPath path;
+    path.addRect(boundingRect());
+    return path;
+}
+
+void Wallpaper::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    if (m_size.isEmpty() || m_tileWidth <= 0)
+        return;
+
+    QRectF visible = option->exposedRect;
+    if (widget)
+        visible = painter->worldTransform().inverted().mapRect(QRectF(widget->rect()));
+    const int firstVisible = static_cast<int>(qMax(qreal(0), visible.left())) / m_tileWidth;
+    const int lastVisible = static_cast<int>(qMax(qreal(0), visible.right())) / m_tileWidth;
+
+    /* ParallaxHome::shiftPage() prepares the tiles before each frame; only a
+       frame painted before the first shift gets here with tiles missing. */
+    for (int i = firstVisible; i <= lastVisible; ++i) {
+        if (i * m_tileWidth < m_size.width() && !m_resident.contains(i)) {
+            prepare(visible);
+            break;
+        }
+    }
+
+    const QPainter::CompositionMode mode = painter->compositionMode();
+    painter->setCompositionMode(QPainter::CompositionMode_Source);
+    for (int i = firstVisible; i <= lastVisible; ++i) {
+        QHash<int, QPixmap>::const_iterator it = m_resident.constFind(i);
+        if (it == m_resident.constEnd())
+            continue;
+
+        const QRectF tileRect(i * m_tileWidth, 0, it.value().width(), it.value().height());
+        if (tileRect.intersects(option->exposedRect))
+            painter->drawPixmap(tileRect.topLeft(), it.value());
+    }
+    painter->setCompositionMode(mode);
 }
 
 
@@ -145,7 +278,6 @@ void ParallaxHome::choosePage(int page)
 void ParallaxHome::shiftPage(int frame)
 {
    int ww = width();
-   int hh = height() - m_naviBar->rect().height();
 
    int oldPage = static_cast<int>(-m_pageOffset);
    m_pageOffset = static_cast<qreal>(frame) / qreal(1000);
@@ -155,19 +287,18 @@ void ParallaxHome::shiftPage(int frame)
    if(oldPage != newPage)
      emit pageChanged(newPage);
 
+   /* Only the two layers move; their children keep the positions set in layoutScene(). */
    int ofs = m_pageOffset * ww;
-   for(int i = 0; i < m_items.count(); ++i)
-   {
-      QPointF pos = m_positions[i];
-      QPointF xy(pos.x() * ww, pos.y() * hh);
-      m_items[i]->setPos(xy + QPointF(ofs, 0));
-   }
+   m_itemLayer->setPos(ofs, 0);
 
-   int center = m_wallpaper->pixmap().width() / 2;
+   int center = m_wallpaper->boundingRect().width() / 2;
    const int parallax = 3;
    int base = center - (ww / 2) - (PAGE_COUNT >> 1) * (ww / parallax);
    int wofs = base - m_pageOffset * ww / parallax;
-   m_wallpaper->setPos(-wofs, 0);
+   m_wallpaperLayer->setPos(-wofs, 0);
+
+   /* Upload the tiles coming into view now, not while painting the frame. */
+   m_wallpaper->prepare(QRectF(wofs, 0, ww, height()));
 }
 
 void ParallaxHome::resizeEvent(QResizeEvent *event)
@@ -195,6 +326,15 @@ void ParallaxHome::layoutScene()
    m_scene.setSceneRect(0, 0, PAGE_COUNT * ww - 1, hh - 1);
    centerOn(ww / 2, hh / 2);
 
+   m_wallpaper->setTileWidth(ww);
+
+   int ih = hh - m_naviBar->rect().height();
+   for(int i = 0; i < m_items.count(); ++i)
+   {
+      QPointF pos = m_positions[i];
+      m_items[i]->setPos(pos.x() * ww, pos.y() * ih);
+   }
+
    int nw = m_naviBar->rect().width();
    int nh = m_naviBar->rect().height();
    m_naviBar->setPos((ww - nw) / 2, hh - nh);
@@ -209,6 +349,20 @@ void ParallaxHome::setupScene()
    names << "brownies" << "cookies" << "mussels" << "pizza" << "sushi";
    names << "chocolate" << "fish" << "pasta" << "puding" << "trouts";
 
+   /* The page items and the wallpaper each hang off a layer item, so that
+      a page shift only has to move the two layers. */
+   m_itemLayer = new QGraphicsRectItem;
+   m_itemLayer->setPen(Qt::NoPen);
+   m_itemLayer->setFlag(QGraphicsItem::ItemHasNoContents);
+   m_itemLayer->setZValue(1);
+   m_scene.addItem(m_itemLayer);
+
+   m_wallpaperLayer = new QGraphicsRectItem;
+   m_wallpaperLayer->setPen(Qt::NoPen);
+   m_wallpaperLayer->setFlag(QGraphicsItem::ItemHasNoContents);
+   m_wallpaperLayer->setZValue(0);
+   m_scene.addItem(m_wallpaperLayer);
+
    for(int i = 0; i < PAGE_COUNT * 2; ++i)
    {
       QString fname = names[i];
@@ -216,13 +370,12 @@ void ParallaxHome::setupScene()
       fname.append(".jpg");
       QPixmap pixmap(fname);
       pixmap = pixmap.scaledToWidth(200);
-      QGraphicsPixmapItem *item = m_scene.addPixmap(pixmap);
+      QGraphicsPixmapItem *item = new QGraphicsPixmapItem(pixmap, m_itemLayer);
       m_items << item;
 
       qreal x = (i >> 1) + (qrand() % 30) / 100.0;
       qreal y = (i & 1) / 2.0  + (qrand() % 20) / 100.0;
       m_positions << QPointF(x, y);
-      item->setZValue(1);
    }
 
    m_naviBar = new NaviBar;
@@ -230,9 +383,12 @@ void ParallaxHome::setupScene()
    m_naviBar->setZValue(2);
    connect(m_naviBar, SIGNAL(pageSelected(int)), SLOT(choosePage(int)));
 
-   m_wallpaper = m_scene.addPixmap(QPixmap(":/icons/surfacing.png"));
-   m_wallpaper->setZValue(0);
+   m_wallpaper = new Wallpaper(":/icons/surfacing.png");
+   m_wallpaper->setParentItem(m_wallpaperLayer);
 
+   /* The layers move on every animation frame and would force a BSP tree to
+      re-index all their children each time. With only a few top-level items,
+      the scene's recursive traversal without an index is the cheaper lookup. */
    m_scene.setItemIndexMethod(QGraphicsScene::NoIndex);
 }
 
@@ -52,8 +52,31 @@ protected:
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = 0);
 
 private:
-    QList<QGraphicsSvgItem*> m_icons;
+    QList<QGraphicsPixmapItem*> m_icons;
     QGraphicsRectItem *m_cursor;
+    int m_currentIcon;
+};
+
+
+class Wallpaper : public QGraphicsItem
+{
+public:
+    Wallpaper(const QString &fileName);
+
+    void setTileWidth(int tileWidth);
+    void prepare(const QRectF &visible);
+
+    QRectF boundingRect() const;
+    QPainterPath opaqueArea() const;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = 0);
+
+private:
+    QImage tile(int index) const;
+
+    QImage m_image;                 /* The wallpaper decoded once, the tiles share its pixels. */
+    QSize m_size;
+    int m_tileWidth;
+    QHash<int, QPixmap> m_resident; /* Pixmaps of the tiles in or near the viewport, by tile index. */
 };
 
 
@@ -64,7 +87,9 @@ class ParallaxHome: public QGraphicsView
 public:
     QGraphicsScene m_scene;
     NaviBar *m_naviBar;
-    QGraphicsPixmapItem *m_wallpaper;
+    Wallpaper *m_wallpaper;
+    QGraphicsRectItem *m_itemLayer;       /* Parent of all page items. */
+    QGraphicsRectItem *m_wallpaperLayer;  /* Parent of the wallpaper. */
     QTimeLine m_pageAnimator;
     qreal m_pageOffset;
     QList<QGraphicsPixmapItem*> m_items;
@@ -43,9 +43,14 @@
 
 #include "wigglywidget.h"
 
+static const int sineTable[16] = {
+    0, 38, 71, 92, 100, 92, 71, 38,	0, -38, -71, -92, -100, -92, -71, -38
+};
+
 //! [0]
 WigglyWidget::WigglyWidget(QWidget *parent)
-    : QWidget(parent)
+    : QWidget(parent), glyphTop(0), glyphHeight(0), textWidth(0), lineHeight(0),
+      baselineShift(0), glyphCacheValid(false)
 {
     setBackgroundRole(QPalette::Midlight);
     setAutoFillBackground(true);
@@ -59,30 +64,107 @@ WigglyWidget::WigglyWidget(QWidget *parent)
 }
 //! [0]
 
-//! [1]
-void WigglyWidget::paintEvent(QPaintEvent * /* event */)
-//! [1] //! [2]
+void WigglyWidget::setText(const QString &newText)
 {
-    static const int sineTable[16] = {
-        0, 38, 71, 92, 100, 92, 71, 38,	0, -38, -71, -92, -100, -92, -71, -38
-    };
+    if (newText == text)
+        return;
+
+    text = newText;
+    glyphCacheValid = false;
+    update();
+}
 
+/* Shape every character once and render it in each of the 16 colours of the
+   wave, so that painting a frame is only a series of pixmap blits. */
+void WigglyWidget::buildGlyphCache()
+{
     QFontMetrics metrics(font());
-    int x = (width() - metrics.width(text)) / 2;
-    int y = (height() + metrics.ascent() - metrics.descent()) / 2;
+    textWidth = metrics.width(text);
+    lineHeight = metrics.height();
+    baselineShift = metrics.ascent() - metrics.descent();
+
+    int top = -metrics.ascent();
+    int bottom = metrics.descent() + 1;
+    int originX = 0;
+    int atlasWidth = 0;
+
+    glyphs.resize(text.size());
+    for (int i = 0; i < text.size(); ++i) {
+        int advance = metrics.width(text[i]);
+        QRect ink = metrics.boundingRect(text[i]);
+
+        Glyph &glyph = glyphs[i];
+        glyph.originX = originX;
+        glyph.left = qMin(0, ink.left());
+        glyph.width = qMax(advance, ink.right() + 1) - glyph.left;
+        glyph.atlasX = atlasWidth;
+
+        top = qMin(top, ink.top());
+        bottom = qMax(bottom, ink.bottom() + 1);
+        originX += advance;
+        atlasWidth += glyph.width;
+    }
+    glyphTop = top;
+    glyphHeight = bottom - top;
+
+    glyphAtlas = QPixmap(qMax(atlasWidth, 1), glyphHeight * 16);
+    glyphAtlas.fill(Qt::transparent);
+
+    QPainter painter(&glyphAtlas);
+    painter.setFont(font());
     QColor color;
+    for (int index = 0; index < 16; ++index) {
+        color.setHsv((15 - index) * 16, 255, 191);
+        painter.setPen(color);
+        int baseline = index * glyphHeight - glyphTop;
+        for (int i = 0; i < glyphs.size(); ++i)
+            painter.drawText(glyphs[i].atlasX - glyphs[i].left, baseline, QString(text[i]));
+    }
+
+    glyphCacheValid = true;
+}
+
+/* Where glyph i is drawn on the widget when the wave is at atStep. */
+QRect WigglyWidget::glyphRect(int i, int atStep) const
+{
+    int x = (width() - textWidth) / 2;
+    int y = (height() + baselineShift) / 2;
+    int index = (atStep + i) % 16;
+
+    const Glyph &glyph = glyphs[i];
+    return QRect(x + glyph.originX + glyph.left,
+                 y - ((sineTable[index] * lineHeight) / 400) + glyphTop,
+                 glyph.width, glyphHeight);
+}
+
+QRegion WigglyWidget::textRegion(int atStep) const
+{
+    QRegion region;
+    for (int i = 0; i < glyphs.size(); ++i)
+        region += glyphRect(i, atStep);
+    return region;
+}
+
+//! [1]
+void WigglyWidget::paintEvent(QPaintEvent *event)
+//! [1] //! [2]
+{
+    if (!glyphCacheValid)
+        buildGlyphCache();
 //! [2]
 
 //! [3]
     QPainter painter(this);
 //! [3] //! [4]
-    for (int i = 0; i < text.size(); ++i) {
+    for (int i = 0; i < glyphs.size(); ++i) {
+        QRect target = glyphRect(i, step);
+        if (!event->region().intersects(target))
+            continue;
+
         int index = (step + i) % 16;
-        color.setHsv((15 - index) * 16, 255, 191);
-        painter.setPen(color);
-        painter.drawText(x, y - ((sineTable[index] * metrics.height()) / 400),
-                         QString(text[i]));
-        x += metrics.width(text[i]);
+        painter.drawPixmap(target.topLeft(), glyphAtlas,
+                           QRect(glyphs[i].atlasX, index * glyphHeight,
+                                 glyphs[i].width, glyphHeight));
     }
 }
 //! [4]
@@ -93,9 +175,21 @@ void WigglyWidget::timerEvent(QTimerEvent *event)
 {
     if (event->timerId() == timer.timerId()) {
         ++step;
-        update();
+        /* Only the old and the new position of the glyphs need repainting. */
+        if (glyphCacheValid)
+            update(textRegion(step - 1) + textRegion(step));
+        else
+            update();
     } else {
 	QWidget::timerEvent(event);
     }
 //! [6]
 }
+
+void WigglyWidget::changeEvent(QEvent *event)
+{
+    if (event->type() == QEvent::FontChange)
+        glyphCacheValid = false;
+
+    QWidget::changeEvent(event);
+}
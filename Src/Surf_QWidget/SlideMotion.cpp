@@ -0,0 +1,112 @@
+/*! \file  SlideMotion.cpp
+    \brief Implementation of SlideMotion class.
+ */
+
+#include "SlideMotion.h"
+
+/*! \fn SlideMotion::SlideMotion()
+    \brief Constructor, a motion at rest at 0.
+ */
+SlideMotion::SlideMotion()
+    : m_from(0.0)
+    , m_to(0.0)
+    , m_velocity(0.0)
+    , m_progress(1.0)
+{
+}
+
+/*! \fn void SlideMotion::start(qreal from, qreal to, qreal velocity)
+    \brief Begin a motion, e.g. at rest for an ease in-out or at (to - from) for a linear start.
+
+    \param[in] from the start position.
+    \param[in] to the target position.
+    \param[in] velocity the start velocity in units per duration.
+    \return NONE.
+ */
+void SlideMotion::start(qreal from, qreal to, qreal velocity)
+{
+    m_from = from;
+    m_to = to;
+    m_velocity = velocity;
+    m_progress = 0.0;
+}
+
+/*! \fn void SlideMotion::retarget(qreal to)
+    \brief Head for a new target, keeping the position and velocity at the current progress.
+
+    The progress starts over, so the new target is reached one duration later.
+
+    \param[in] to the new target position.
+    \return NONE.
+ */
+void SlideMotion::retarget(qreal to)
+{
+    start(position(), to, velocity());
+}
+
+/*! \fn void SlideMotion::setProgress(qreal progress)
+    \brief Move along the motion.
+
+    \param[in] progress 0 at the start to 1 at the target.
+    \return NONE.
+ */
+void SlideMotion::setProgress(qreal progress)
+{
+    m_progress = qBound((qreal)0.0, progress, (qreal)1.0);
+}
+
+/*! \fn qreal SlideMotion::progress() const
+    \brief Return how far along the motion is.
+
+    \param[in] NONE.
+    \return 0 at the start to 1 at the target.
+ */
+qreal SlideMotion::progress() const
+{
+    return m_progress;
+}
+
+/*! \fn qreal SlideMotion::position() const
+    \brief Return the position at the current progress.
+
+    \param[in] NONE.
+    \return the position.
+ */
+qreal SlideMotion::position() const
+{
+    const qreal t = m_progress;
+
+    /* The Hermite basis of the start velocity and of the distance, the end velocity is 0. */
+    const qreal h10 = t * (1.0 - t) * (1.0 - t);
+    const qreal h01 = t * t * (3.0 - 2.0 * t);
+
+    return m_from + m_velocity * h10 + (m_to - m_from) * h01;
+}
+
+/*! \fn qreal SlideMotion::velocity() const
+    \brief Return the velocity at the current progress.
+
+    \param[in] NONE.
+    \return the velocity in units per duration.
+ */
+qreal SlideMotion::velocity() const
+{
+    const qreal t = m_progress;
+
+    /* The derivatives of the basis in position(). */
+    const qreal d10 = (1.0 - t) * (1.0 - 3.0 * t);
+    const qreal d01 = 6.0 * t * (1.0 - t);
+
+    return m_velocity * d10 + (m_to - m_from) * d01;
+}
+
+/*! \fn qreal SlideMotion::target() const
+    \brief Return the position the motion comes to rest at.
+
+    \param[in] NONE.
+    \return the target position.
+ */
+qreal SlideMotion::target() const
+{
+    return m_to;
+}
@@ -9,35 +9,72 @@
     \n 1) 2010-06-28 William.L initialized.
  */
 
+#include <QSettings>
+#include <QDesktopWidget>
+
+#ifdef Q_WS_X11
+#include <QX11Info>
+#endif
+
 #include "SlidingWindow.h"
 
-/* The dimension of the main window. */
+/* The default dimension of the main window. */
 #define MAIN_WIN_WIDTH  1024
 #define MAIN_WIN_HEIGHT  600
 
+/* The optional configuration file overriding the default geometry, e.g.
+     [Window]
+     Width=800
+     Height=480
+     FitScreen=false
+     [Layout]
+     AnimationDuration=400
+ */
+#define DFLT_CONFIG_FILE "SlidingWindow.ini"
+
 /* The initial position of control panel. */
 #define CTRL_PANEL_POS_X 570
 #define CTRL_PANEL_POS_Y 640
 
-/* The dimension of each item. */
-#define ITEM_WIDTH   350
-#define ITEM_HEIGHT  MAIN_WIN_HEIGHT
-
 #define ITEM_START_X 0  /* The starting position of the item on the sliding window. */
 #define ITEM_X_OFFSET 0.0
-#define ANIMATION_DURATION 400  /* This is the animation duration in milliseconds. */
+#define ANIMATION_DURATION 400  /* This is the default animation duration in milliseconds. */
 #define IDX_HOMESCREEN 0  /* This is the index number indicating the widget to be HomeScreen. */
 
 #define DEBUG // To show debugging messages.
 
-/*! \fn void SlidingWindow::SlidingWindow()
-    \brief Constructor.
+/*! \fn static bool isCompositingManagerRunning()
+    \brief Check if a compositing manager blends translucent windows with what is behind them.
 
     \param[in] NONE.
+    \return true if translucent windows are composited.
+ */
+static bool isCompositingManagerRunning()
+{
+#if defined(Q_WS_X11)
+    return QX11Info::isCompositingManagerRunning();
+#else
+    /* Other window systems, and Qt5, have no portable way to ask; assume they composite. */
+    return true;
+#endif
+}
+
+/*! \fn void SlidingWindow::SlidingWindow(int options)
+    \brief Constructor.
+
+    \param[in] options the switched on features, OR-ed SlidingWindowOption values.
     \return NONE.
  */
-SlidingWindow::SlidingWindow()
+SlidingWindow::SlidingWindow(int options)
         : m_slidingSurface(new QWidget(this))
+        , m_slideRatio(0.0)
+        , m_idxMountedFirst(-1)
+        , m_idxMountedSecond(-1)
+        , m_snapshotTransitions((options & SW_SNAPSHOT_TRANSITIONS) != 0)
+        , m_snapshotActive(false)
+        , m_idxSnapshotFirst(-1)
+        , m_nAnimationDuration(ANIMATION_DURATION)
+        , m_nOptions(options)
         , m_flipClock(NULL)
         , m_digitClock(NULL)
         , m_analogClock(NULL)
@@ -47,18 +84,37 @@ SlidingWindow::SlidingWindow()
     /* Set the view widget to be frameless. */
     setWindowFlags(Qt::FramelessWindowHint);
 
-#ifdef ENABLE_TRANSPARENT_FRAME
-    /* To set the scene's background to be transparent */
-    /* LOOK! These two lines will take effect only when COMPIZ(compositing manager) is OPENED */
-    /* When using this line, it must set WindowFlags "Qt::FramelessWindowHint" */
-    setAttribute(Qt::WA_TranslucentBackground);
+    /* A translucent window is rendered into an ARGB32 backing store and blended
+       every frame, which is wasted without a compositing manager to show it. */
+    if (testOption(SW_TRANSPARENT_FRAME) && !isCompositingManagerRunning())
+    {
+       #ifdef DEBUG
+       qDebug("%s : %s(%d) - No compositing manager, use an opaque window.", __FILE__, __FUNCTION__, __LINE__);
+       #endif
 
-    /* Someone may suggest this way. */
-    //setStyleSheet("background: transparent");
-#endif
+       m_nOptions &= ~SW_TRANSPARENT_FRAME;
+    }
+
+    if (testOption(SW_TRANSPARENT_FRAME))
+    {
+       /* To set the scene's background to be transparent */
+       /* LOOK! These two lines will take effect only when COMPIZ(compositing manager) is OPENED */
+       /* When using this line, it must set WindowFlags "Qt::FramelessWindowHint" */
+       setAttribute(Qt::WA_TranslucentBackground);
 
-    /* Set the sliding window size. */
-    setFixedSize((int)MAIN_WIN_WIDTH, (int)MAIN_WIN_HEIGHT);
+       /* Someone may suggest this way. */
+       //setStyleSheet("background: transparent");
+    }
+    else
+    {
+       /* The window fills the background itself in paintEvent(), so it needs
+          neither clearing nor blending before each paint. */
+       setAttribute(Qt::WA_OpaquePaintEvent);
+       setAttribute(Qt::WA_NoSystemBackground);
+    }
+
+    /* Set the sliding window size from the configuration file or the screen. */
+    setFixedSize(loadLayout());
 
     m_idxFocusedItem = (qreal)IDX_HOMESCREEN;
     m_idxOldFocusedItem = (int)IDX_HOMESCREEN;
@@ -79,12 +135,17 @@ SlidingWindow::SlidingWindow()
     /* Add default item onto sliding window */
     addDefaultWidgetItems();
 
-    /* Create an animation object. */
-    m_animationSlide = new QPropertyAnimation(this, "slideOffset");
+    /* Create an animation object. It runs the progress of m_motion, see animateTo(). */
+    m_animationSlide = new QPropertyAnimation(this, "slideProgress");
+    m_animationSlide->setStartValue(0.0);
+    m_animationSlide->setEndValue(1.0);
 
     /* Set the animation duration */
     if (m_animationSlide)
-       m_animationSlide->setDuration(ANIMATION_DURATION);
+       m_animationSlide->setDuration(m_nAnimationDuration);
+
+    /* Bring the live panels back when a transition ends. */
+    QObject::connect(m_animationSlide, SIGNAL(finished()), this, SLOT(slideFinished()));
 
     /* Set "slideOffset" property to initial value "0.0" that is the location of "HomeScreent" widget */
     setSlideOffset (0.0f + IDX_HOMESCREEN*1.0f);
@@ -93,6 +154,38 @@ SlidingWindow::SlidingWindow()
     m_slideControl.pushButtonLeft->setEnabled(false);
 }
 
+/*! \fn QSize SlidingWindow::loadLayout()
+    \brief Load the window geometry and slide layout of this device.
+
+    The size comes from the configuration file when it has one, from the
+    screen when "FitScreen" is set, and from the built-in default otherwise.
+
+    \param[in] NONE.
+    \return the window size.
+ */
+QSize SlidingWindow::loadLayout()
+{
+    QSettings settings(DFLT_CONFIG_FILE, QSettings::IniFormat);
+    QSize winSize(settings.value("Window/Width", (int)MAIN_WIN_WIDTH).toInt(),
+                  settings.value("Window/Height", (int)MAIN_WIN_HEIGHT).toInt());
+
+    /* Set the window size fitting the dimension of the screen, e.g. for real device. */
+    if (settings.value("Window/FitScreen", false).toBool())
+       winSize = QApplication::desktop()->screenGeometry().size();
+
+    if (winSize.isEmpty())
+       winSize = QSize((int)MAIN_WIN_WIDTH, (int)MAIN_WIN_HEIGHT);
+
+    m_nAnimationDuration = settings.value("Layout/AnimationDuration", (int)ANIMATION_DURATION).toInt();
+
+    #ifdef DEBUG
+    qDebug("%s : %s(%d) - window = %dx%d, animation = %d ms", __FILE__, __FUNCTION__, __LINE__,
+           winSize.width(), winSize.height(), m_nAnimationDuration);
+    #endif
+
+    return winSize;
+}
+
 /*! \fn void SlidingWindow::setSlideOffset(qreal slideRatio)
     \brief Set the offset value for moving items.
 
@@ -100,35 +193,250 @@ SlidingWindow::SlidingWindow()
     \return NONE.
  */
 void SlidingWindow::setSlideOffset(qreal slideRatio)
-{        
-    // we use a ratio to handle resize corectly
-    const int pos = -qRound(slideRatio * width());
+{
+    if (m_slidePanelItems.isEmpty())
+       return;
 
-    m_slidingSurface->scroll(pos - m_slidePanelItems[IDX_HOMESCREEN]->x(), 0);
+    m_slideRatio = slideRatio;
 
-    if (qFuzzyCompare(slideRatio, static_cast<qreal>(m_itemSlideOffset)))
-    {
-       m_slidePanelItems[m_idxOldFocusedItem]->hide();
-       m_slidePanelItems[m_idxFocusedItem]->show();
-    }
-    else
+    /* While sliding snapshots, the panels stay hidden; just repaint the pixmaps. */
+    if (m_snapshotActive)
     {
-       m_slidePanelItems[m_idxFocusedItem]->show();
-       m_slidePanelItems[m_idxOldFocusedItem]->show();
+       update();
+       return;
     }
+
+    /* The sliding surface holds at most the two panels under the window;
+       the integer part selects them, the fraction is how far it is scrolled. */
+    const int lastIdx = m_slidePanelItems.count() - 1;
+    const int idxFirst = qBound(0, qFloor(slideRatio), lastIdx);
+    const qreal fraction = qBound(static_cast<qreal>(0.0), slideRatio - idxFirst, static_cast<qreal>(1.0));
+    const int idxSecond = (fraction > 0.0 && idxFirst < lastIdx) ? (idxFirst + 1) : -1;
+
+    mountPanels(idxFirst, idxSecond);
+
+    /* Moving the surface lets Qt blit the panel pixels already on screen. */
+    m_slidingSurface->move(-qRound(fraction * width()), 0);
 }
 
 /*! \fn qreal SlidingWindow::slideOffset() const
-    \brief Calculate and return the offset value for moving items.
+    \brief Return the offset value for moving items.
 
     \param[in] NONE.
     \return value of qreal type.
  */
 qreal SlidingWindow::slideOffset() const
 {
-    Q_ASSERT(m_slidingSurface->x() < width());
+    return m_slideRatio;
+}
+
+/*! \fn void SlidingWindow::setSlideProgress(qreal progress)
+    \brief Move the panels along the running slide animation.
+
+    \param[in] progress of the animation, 0 to 1.
+    \return NONE.
+ */
+void SlidingWindow::setSlideProgress(qreal progress)
+{
+    m_motion.setProgress(progress);
+    setSlideOffset(m_motion.position());
+}
+
+/*! \fn qreal SlidingWindow::slideProgress() const
+    \brief Return the progress of the slide animation.
 
-    return static_cast<qreal>(qAbs(m_slidePanelItems[IDX_HOMESCREEN]->x()))/width();
+    \param[in] NONE.
+    \return value of qreal type.
+ */
+qreal SlidingWindow::slideProgress() const
+{
+    return m_motion.progress();
+}
+
+/*! \fn void SlidingWindow::animateTo(qreal slideRatio)
+    \brief Slide to an offset, or retarget the running slide to it.
+
+    A running slide goes on from where it is and at its speed, and reaches
+    the new offset one animation duration later. A new one starts at the
+    speed of a linear slide and comes to rest at the offset.
+
+    \param[in] slideRatio the offset to slide to, in units of panels.
+    \return NONE.
+ */
+void SlidingWindow::animateTo(qreal slideRatio)
+{
+    if (m_animationSlide->state() == QAbstractAnimation::Running)
+    {
+       /* The two snapshots may not cover the way to the new offset, slide the live panels. */
+       endSnapshotTransition();
+
+       m_motion.retarget(slideRatio);
+       m_animationSlide->stop();
+    }
+    else
+    {
+       if (m_snapshotTransitions && m_idxFocusedItem != m_idxOldFocusedItem)
+          beginSnapshotTransition(qMin(m_idxFocusedItem, m_idxOldFocusedItem));
+
+       m_motion.start(slideOffset(), slideRatio, slideRatio - slideOffset());
+    }
+
+    m_animationSlide->start();
+}
+
+/*! \fn void SlidingWindow::mountPanels(int idxFirst, int idxSecond)
+    \brief Put the given panels onto the sliding surface and take all others off.
+
+    \param[in] index of the panel at the left slot of the surface.
+    \param[in] index of the panel at the right slot of the surface, or -1 for none.
+    \return NONE.
+ */
+void SlidingWindow::mountPanels(int idxFirst, int idxSecond)
+{
+    if (idxFirst == m_idxMountedFirst && idxSecond == m_idxMountedSecond)
+       return;
+
+    /* Take the panels that are no longer under the window off the surface. */
+    if (m_idxMountedFirst >= 0 && m_idxMountedFirst != idxFirst && m_idxMountedFirst != idxSecond)
+       unmountPanel(m_slidePanelItems[m_idxMountedFirst]);
+    if (m_idxMountedSecond >= 0 && m_idxMountedSecond != idxFirst && m_idxMountedSecond != idxSecond)
+       unmountPanel(m_slidePanelItems[m_idxMountedSecond]);
+
+    mountPanel(m_slidePanelItems[idxFirst], 0);
+    if (idxSecond >= 0)
+       mountPanel(m_slidePanelItems[idxSecond], 1);
+
+    m_idxMountedFirst = idxFirst;
+    m_idxMountedSecond = idxSecond;
+}
+
+/*! \fn void SlidingWindow::mountPanel(QWidget *panel, int slot)
+    \brief Parent a panel to the sliding surface at the given slot and show it.
+
+    \param[in] QWidget object.
+    \param[in] slot of the surface, 0 for the left and 1 for the right.
+    \return NONE.
+ */
+void SlidingWindow::mountPanel(QWidget *panel, int slot)
+{
+    if (panel->parentWidget() != m_slidingSurface)
+       panel->setParent(m_slidingSurface);
+
+    panel->setGeometry(((int)ITEM_START_X + slot * width()), 0, width(), height());
+    panel->show();
+}
+
+/*! \fn void SlidingWindow::unmountPanel(QWidget *panel)
+    \brief Hide a panel and park it outside of the sliding surface.
+
+    \param[in] QWidget object.
+    \return NONE.
+ */
+void SlidingWindow::unmountPanel(QWidget *panel)
+{
+    panel->hide();
+    panel->setParent(this);
+}
+
+/*! \fn void SlidingWindow::setSnapshotTransitions(bool enable)
+    \brief Choose whether transitions slide snapshots or the live panels.
+
+    \param[in] true to slide pixmaps grabbed when the transition starts.
+    \return NONE.
+ */
+void SlidingWindow::setSnapshotTransitions(bool enable)
+{
+    m_snapshotTransitions = enable;
+
+    if (enable)
+       m_nOptions |= SW_SNAPSHOT_TRANSITIONS;
+    else
+       m_nOptions &= ~SW_SNAPSHOT_TRANSITIONS;
+}
+
+/*! \fn bool SlidingWindow::snapshotTransitions() const
+    \brief Return whether transitions slide snapshots of the panels.
+
+    \param[in] NONE.
+    \return value of bool type.
+ */
+bool SlidingWindow::snapshotTransitions() const
+{
+    return m_snapshotTransitions;
+}
+
+/*! \fn bool SlidingWindow::testOption(SlidingWindowOption option) const
+    \brief Check if a feature of the sliding window is switched on.
+
+    \param[in] option the feature to check.
+    \return value of bool type.
+ */
+bool SlidingWindow::testOption(SlidingWindowOption option) const
+{
+    return (m_nOptions & option) != 0;
+}
+
+/*! \fn void SlidingWindow::beginSnapshotTransition(int idxFirst)
+    \brief Grab the two panels of a transition and hide the live ones.
+
+    \param[in] index of the left one of the two panels.
+    \return NONE.
+ */
+void SlidingWindow::beginSnapshotTransition(int idxFirst)
+{
+    if (idxFirst < 0 || idxFirst + 1 >= m_slidePanelItems.count())
+       return;
+
+    QWidget *first = m_slidePanelItems[idxFirst];
+    QWidget *second = m_slidePanelItems[idxFirst + 1];
+
+    /* Parked panels may not have been laid out for the current size yet. */
+    first->resize(size());
+    second->resize(size());
+
+    #if QT_VERSION < 0x050000
+    m_snapshotFirst = QPixmap::grabWidget(first);
+    m_snapshotSecond = QPixmap::grabWidget(second);
+    #else
+    m_snapshotFirst = first->grab();
+    m_snapshotSecond = second->grab();
+    #endif
+
+    m_idxSnapshotFirst = idxFirst;
+    m_snapshotActive = true;
+    m_slidingSurface->hide();
+}
+
+/*! \fn void SlidingWindow::slideFinished()
+    \brief The slot called when the slide animation finished; restore the live panels.
+
+    \param[in] NONE.
+    \return NONE.
+ */
+void SlidingWindow::slideFinished()
+{
+    endSnapshotTransition();
+}
+
+/*! \fn void SlidingWindow::endSnapshotTransition()
+    \brief Drop the snapshots of a transition and show the live panels again.
+
+    \param[in] NONE.
+    \return NONE.
+ */
+void SlidingWindow::endSnapshotTransition()
+{
+    if (!m_snapshotActive)
+       return;
+
+    m_snapshotActive = false;
+    m_snapshotFirst = QPixmap();
+    m_snapshotSecond = QPixmap();
+    m_idxSnapshotFirst = -1;
+
+    setSlideOffset(m_slideRatio);
+    m_slidingSurface->show();
+    update();
 }
 
 /*! \fn void SlidingWindow::addWidgetItem(QWidget* widget)
@@ -142,8 +450,9 @@ void SlidingWindow::addWidgetItem(QWidget* widget)
     if (widget == NULL)
       return;
 
-    /* Set the parent of the widget item. */
-    widget->setParent(m_slidingSurface);
+    /* Park the widget item until it is slid onto the surface. */
+    widget->setParent(this);
+    widget->hide();
 
     /* Add the new created widget to the item list. */
     m_slidePanelItems += widget;
@@ -159,34 +468,30 @@ void SlidingWindow::addDefaultWidgetItems()
 {
    /* Flipping digital clock */
    m_flipClock = new DigiFlip();
-   m_flipClock->resize(ITEM_WIDTH, ITEM_HEIGHT);
+   m_flipClock->resize(size());
    addWidgetItem(m_flipClock);
 
    /* Digital number clock */
    m_digitClock = new DigitalClock();
    m_digitClock->setWindowFlags(Qt::FramelessWindowHint);  /* Set the view widget to be frameless. */
-   m_digitClock->resize(ITEM_WIDTH, ITEM_HEIGHT);
+   m_digitClock->resize(size());
    addWidgetItem(m_digitClock);
 
    /* Analog clock */
    m_analogClock = new AnalogClock();
-   #ifdef ENABLE_TRANSPARENT_FRAME
-   m_analogClock->setStyleSheet("background: transparent");
-   #endif
-   m_analogClock->resize(ITEM_WIDTH, ITEM_HEIGHT);
+   if (testOption(SW_TRANSPARENT_FRAME))
+      m_analogClock->setStyleSheet("background: transparent");
+   m_analogClock->resize(size());
    addWidgetItem(m_analogClock);
 
    /* Wiggly text */
    m_wigglyText = new WigglyText(0, true);  /* true for using small screen. */
-   #ifdef ENABLE_TRANSPARENT_FRAME
-   m_analogClock->setStyleSheet("background: transparent");
-   #endif
-   m_wigglyText->resize(ITEM_WIDTH, ITEM_HEIGHT);
+   m_wigglyText->resize(size());
    addWidgetItem(m_wigglyText);
 
    /* Parallax Home */
    m_parallaxHome = new ParallaxHome();  /* true for using small screen. */
-   m_parallaxHome->resize(ITEM_WIDTH, ITEM_HEIGHT);
+   m_parallaxHome->resize(size());
    addWidgetItem(m_parallaxHome);
 }
 
@@ -202,13 +507,6 @@ void SlidingWindow::slideLeft()
     qDebug(" Sliding Left! ");
     #endif
 
-    if (m_animationSlide->state() == QAbstractAnimation::Running)
-    {
-       qDebug ("%s - %s(%d) : Animation is still running!", __FILE__, __FUNCTION__, __LINE__);
-
-       return;
-    }
-
     m_idxOldFocusedItem = m_idxFocusedItem;
 
    /* If the index of the focused item is greater than
@@ -221,10 +519,7 @@ void SlidingWindow::slideLeft()
    else
      m_idxFocusedItem = m_idxOldFocusedItem;
 
-   m_animationSlide->setDirection(QAbstractAnimation::Forward);
-   m_animationSlide->setStartValue(slideOffset());
-   m_animationSlide->setEndValue(m_itemSlideOffset);
-   m_animationSlide->start();
+   animateTo(m_itemSlideOffset);
 
    /* If the view reach the LEFT/RIGHT boundary, disable LEFT/RIGHT push button. */
    m_slideControl.pushButtonLeft->setEnabled( (m_idxFocusedItem != 0) );
@@ -243,13 +538,6 @@ void SlidingWindow::slideRight()
    qDebug(" Sliding Right! ");
    #endif
 
-   if(m_animationSlide->state() == QAbstractAnimation::Running)
-   {
-      qDebug ("%s - %s(%d) : Animation is still running!", __FILE__, __FUNCTION__, __LINE__);
-
-      return;
-   }
-
    m_idxOldFocusedItem = m_idxFocusedItem;
 
    if(++m_idxFocusedItem <= m_slidePanelItems.count()-1)
@@ -260,16 +548,81 @@ void SlidingWindow::slideRight()
    else
       m_idxFocusedItem = m_idxOldFocusedItem;
 
-   m_animationSlide->setDirection(QAbstractAnimation::Forward);
-   m_animationSlide->setStartValue(slideOffset());
-   m_animationSlide->setEndValue(m_itemSlideOffset);
-   m_animationSlide->start();
+   animateTo(m_itemSlideOffset);
+
+   /* If the view reach the LEFT/RIGHT boundary, disable LEFT/RIGHT push button. */
+   m_slideControl.pushButtonLeft->setEnabled( (m_idxFocusedItem != 0) );
+   m_slideControl.pushButtonRight->setEnabled( (m_idxFocusedItem != (m_slidePanelItems.count()-1)) );
+}
+
+/*! \fn void SlidingWindow::goToSlide(int index, bool animate)
+    \brief Show a panel straight away, without passing the panels in between.
+
+    Only the panel, and its neighbour while animating, are put on the sliding
+    surface. An animated jump lands next to the panel and slides the last
+    panel width only.
+
+    \param[in] index of the panel.
+    \param[in] true to slide into the panel, false to cut to it.
+    \return NONE.
+ */
+void SlidingWindow::goToSlide(int index, bool animate)
+{
+   if (m_slidePanelItems.isEmpty())
+      return;
+
+   index = qBound(0, index, m_slidePanelItems.count() - 1);
+
+   /* The jump replaces the running slide. */
+   m_animationSlide->stop();
+   endSnapshotTransition();
+
+   m_idxOldFocusedItem = index;
+   if (animate && index != m_idxFocusedItem)
+      m_idxOldFocusedItem = (index > m_idxFocusedItem) ? index - 1 : index + 1;
+
+   m_idxFocusedItem = index;
+   m_itemSlideOffset = index;
+   m_slidePanelItems[m_idxFocusedItem]->setFocus();
+
+   setSlideOffset(m_idxOldFocusedItem);
+   if (m_idxOldFocusedItem != m_idxFocusedItem)
+      animateTo(m_itemSlideOffset);
 
    /* If the view reach the LEFT/RIGHT boundary, disable LEFT/RIGHT push button. */
    m_slideControl.pushButtonLeft->setEnabled( (m_idxFocusedItem != 0) );
    m_slideControl.pushButtonRight->setEnabled( (m_idxFocusedItem != (m_slidePanelItems.count()-1)) );
 }
 
+/*! \fn void SlidingWindow::paintEvent(QPaintEvent *event)
+    \brief Override QWidget's default event handler to draw the panel snapshots.
+
+    \param[in] QPaintEvent object.
+    \return NONE.
+ */
+void SlidingWindow::paintEvent(QPaintEvent *event)
+{
+   if (!m_snapshotActive)
+   {
+      /* An opaque window clears its background itself, see the constructor. */
+      if (testAttribute(Qt::WA_OpaquePaintEvent))
+      {
+         QPainter painter(this);
+         painter.fillRect(event->rect(), palette().brush(QPalette::Window));
+      }
+      else
+         QWidget::paintEvent(event);
+
+      return;
+   }
+
+   const int pos = -qRound((m_slideRatio - m_idxSnapshotFirst) * width());
+
+   QPainter painter(this);
+   painter.drawPixmap(pos, 0, m_snapshotFirst);
+   painter.drawPixmap(pos + width(), 0, m_snapshotSecond);
+}
+
 /*! \fn void SlidingWindow::resizeEvent(QResizeEvent *event)
     \brief Override QWidget's default event handler.
 
@@ -278,23 +631,12 @@ void SlidingWindow::slideRight()
  */
 void SlidingWindow::resizeEvent(QResizeEvent *event)
 {
-   int new_width = 0;
-   const QSize oldSize = event->oldSize();
-   const qreal oldSlidingRatio = static_cast<qreal>(qAbs(m_slidePanelItems[IDX_HOMESCREEN]->x())) / oldSize.width();
    const QSize newSize = event->size();
 
-   /* Set width of the sliding window(canvas) */
-   m_slidingSurface->resize((newSize.width()*m_slidePanelItems.count()), newSize.height());
-
-   /* Store the new width */
-   new_width = newSize.width();
-
-   /* Set the widgets' size to fit the size of the sliding window. */
-   for(int i = 0; i < m_slidePanelItems.count(); i++)
-   {
-       m_slidePanelItems[i]->resize(newSize);
-       m_slidePanelItems[i]->move(((int)ITEM_START_X + i*newSize.width()), 0);
-   }
+   /* The sliding surface spans two panels, whatever the number of items. */
+   m_slidingSurface->resize(newSize.width() * 2, newSize.height());
 
-   setSlideOffset(oldSlidingRatio);
+   /* Re-place the mounted panels for the new size. */
+   m_idxMountedFirst = m_idxMountedSecond = -1;
+   setSlideOffset(m_slideRatio);
 }
@@ -18,6 +18,7 @@
 #include <QDebug>
 
 #include "ui_SlidingWindowForm.h"
+#include "SlideMotion.h"
 //
 #include "Apps/DigiFlip/digiflip.h"
 #include "Apps/DigitalClock/digitalclock.h"
@@ -27,6 +28,17 @@
 
 class QPropertyAnimation;
 
+/*! \enum SlidingWindowOption
+    \brief The features of the sliding window which can be switched at runtime.
+*/
+enum SlidingWindowOption{
+    SW_TRANSPARENT_FRAME = 0x01,    /* Transparent window frame, needs a compositing manager. */
+    SW_SNAPSHOT_TRANSITIONS = 0x02  /* Slide snapshots of the panels, see setSnapshotTransitions(). */
+};
+
+/* The features of the sliding window by default. */
+#define DFLT_SLIDING_WINDOW_OPTIONS  (SW_TRANSPARENT_FRAME | SW_SNAPSHOT_TRANSITIONS)
+
 /*! \class SlidingWindow
     \brief The sliding window class.
 */
@@ -34,11 +46,21 @@ class SlidingWindow : public QWidget
 {
     Q_OBJECT
     Q_PROPERTY(qreal slideOffset READ slideOffset WRITE setSlideOffset)
+    Q_PROPERTY(qreal slideProgress READ slideProgress WRITE setSlideProgress)
 
 private:
-    QWidget *m_slidingSurface; /* e.g. Canvas. */
+    QWidget *m_slidingSurface; /* e.g. Canvas. Holds at most the two panels under the window. */
     QList<QWidget*> m_slidePanelItems;  /* The list of panel items in QWidget type.  */
+    qreal m_slideRatio;  /* The current slide offset, in units of panels. */
+    int m_idxMountedFirst, m_idxMountedSecond;  /* The panels on the sliding surface, -1 for none. */
+    bool m_snapshotTransitions;  /* Slide snapshots of the panels instead of the live panels. */
+    bool m_snapshotActive;       /* A snapshot transition is running. */
+    int m_idxSnapshotFirst;      /* The panel grabbed into m_snapshotFirst. */
+    QPixmap m_snapshotFirst, m_snapshotSecond;  /* The two panels of the running transition. */
+    int m_nAnimationDuration;  /* The duration of the slide animation in milliseconds. */
+    int m_nOptions;  /* The switched on features, OR-ed SlidingWindowOption values. */
     QPropertyAnimation *m_animationSlide;
+    SlideMotion m_motion;  /* The path of the running slide, retargeted by new slides. */
     int m_idxFocusedItem, m_idxOldFocusedItem;
     qreal m_itemSlideOffset;
     Ui::CustSlideControlForm m_slideControl;
@@ -51,23 +73,38 @@ private:
     ParallaxHome *m_parallaxHome;
 
 public:
-    SlidingWindow();
+    SlidingWindow(int options = DFLT_SLIDING_WINDOW_OPTIONS);
+    bool testOption(SlidingWindowOption option) const;
     void addWidgetItem(QWidget* widget);
     void addDefaultWidgetItems();  /* Add default widges into sliding panel */
+    void setSnapshotTransitions(bool enable);
+    bool snapshotTransitions() const;
+    void goToSlide(int index, bool animate = true);  /* Show a panel without passing the ones in between. */
 
 /* Private functions. */
 private:
+    QSize loadLayout();  /* Load the window geometry and slide layout. */
     void setSlideOffset(qreal);
     qreal slideOffset() const;
+    void setSlideProgress(qreal);
+    qreal slideProgress() const;
+    void animateTo(qreal slideRatio);
+    void mountPanels(int idxFirst, int idxSecond);
+    void mountPanel(QWidget *panel, int slot);
+    void unmountPanel(QWidget *panel);
+    void beginSnapshotTransition(int idxFirst);
+    void endSnapshotTransition();
 
 /* Reimplement QWidget's default event. */
 protected:
+    void paintEvent(QPaintEvent *event);
     void resizeEvent(QResizeEvent *event);
 
 private slots:
     /* The event handlers for sliding item event. */
     void slideLeft();
     void slideRight();
+    void slideFinished();
 };
 
 #endif /* End of SLIDINGPANELCUST_H */
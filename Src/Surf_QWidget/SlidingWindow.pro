@@ -9,6 +9,7 @@ INCLUDEPATH += .
 
 # Input
 HEADERS += SlidingWindow.h \
+           SlideMotion.h \
            Apps/DigiFlip/digiflip.h \
            Apps/DigitalClock/digitalclock.h \
            Apps/AnalogClock/analogclock.h \
@@ -20,6 +21,7 @@ FORMS += SlidingWindowForm.ui
 
 SOURCES += main.cpp \
            SlidingWindow.cpp \
+           SlideMotion.cpp \
            Apps/DigiFlip/digiflip.cpp \
            Apps/DigitalClock/digitalclock.cpp \
            Apps/AnalogClock/analogclock.cpp \
@@ -29,8 +31,6 @@ SOURCES += main.cpp \
 
 RESOURCES = Apps/ParallaxHome/parallaxhome.qrc
 
-DEFINES += ENABLE_TRANSPARENT_FRAME
-
 QT += gui
 QT += svg
 # Added for Qt5, 2015-09-10. Begin
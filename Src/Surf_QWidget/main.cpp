@@ -11,6 +11,7 @@
 
 #include <QtGlobal>  // Added for Qt5, 2015-09-10.
 #include <QApplication>
+#include <QStringList>
 
 #include "SlidingWindow.h"
 
@@ -18,6 +19,32 @@
 #define START_POS_X 120
 #define START_POS_Y  25
 
+/*! \fn int parseOptions(const QStringList &args, int options)
+    \brief Switch the features of the sliding window on/off from the command line,
+           e.g. "-snapshot" switches it on and "-nosnapshot" switches it off.
+
+    \param[in] args the command line arguments.
+    \param[in] options the default features.
+    \return the features to create the sliding window with.
+ */
+static int parseOptions(const QStringList &args, int options)
+{
+   static const struct { const char *name; SlidingWindowOption option; } switches[] = {
+      { "transparent", SW_TRANSPARENT_FRAME },
+      { "snapshot", SW_SNAPSHOT_TRANSITIONS }
+   };
+
+   for (unsigned int i = 0; i < sizeof(switches) / sizeof(switches[0]); i++)
+   {
+      if (args.contains(QString("-%1").arg(switches[i].name)))
+         options |= switches[i].option;
+      else if (args.contains(QString("-no%1").arg(switches[i].name)))
+         options &= ~switches[i].option;
+   }
+
+   return options;
+}
+
 int main(int argc, char* argv[])
 {
    /* Changed for Qt5, 2015-09-10
@@ -33,7 +60,7 @@ int main(int argc, char* argv[])
    app.setApplicationName("SlidingWindow");
    app.setApplicationVersion("0.1");
 
-   SlidingWindow *slidingWindow = new SlidingWindow();
+   SlidingWindow *slidingWindow = new SlidingWindow(parseOptions(app.arguments(), DFLT_SLIDING_WINDOW_OPTIONS));
    slidingWindow->move(QPoint(START_POS_X, START_POS_Y));
    slidingWindow->show();
 